@@ -0,0 +1,110 @@
+#ifndef ENV_SCHEDULE_H
+#define ENV_SCHEDULE_H
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/vector.h"
+#include "tools/Random.h"
+
+/// One trial's environment schedule, generated up front, plus the agent's internal state changes over
+/// the trial. Instead of comparing agent and environment states every time step, the env-match score
+/// (number of time steps in which the agent's state equals the environment's) is computed once, at the
+/// end of the trial, by intersecting the two sets of state intervals.
+/// Changes take effect at their time step: at time t, the environment is in the state of its last change
+/// at or before t, and so is the agent (changes the agent makes during step t count at step t).
+class EnvSchedule {
+public:
+  static constexpr size_t NO_STATE = (size_t)-1;
+
+  struct Change {
+    size_t time;
+    size_t state;
+  };
+
+protected:
+  emp::vector<Change> env_changes;    ///< In time order; first change is at time 0.
+  emp::vector<Change> agent_changes;  ///< In time order.
+  size_t next_env_change;
+
+public:
+  EnvSchedule() : env_changes(), agent_changes(), next_env_change(0) { ; }
+
+  const emp::vector<Change> & GetEnvChanges() const { return env_changes; }
+  const emp::vector<Change> & GetAgentChanges() const { return agent_changes; }
+
+  /// Random schedule over [0:end_time): environment changes to a random state at time 0, then at every
+  /// later time step with probability change_prob. Time between changes is drawn from the geometric
+  /// distribution, so this takes a couple of draws per change rather than one per time step.
+  void GenerateRandom(emp::Random & random, double change_prob, size_t state_cnt, size_t end_time) {
+    Reset();
+    if (!end_time) return;
+    env_changes.emplace_back(Change{0, random.GetUInt(state_cnt)});
+    if (change_prob <= 0) return;
+    const double log_stay = std::log(1.0 - std::min(change_prob, 1.0));
+    size_t time = 0;
+    while (true) {
+      // Steps until next change: 1 + floor(ln(U)/ln(1-p)), U in (0:1].
+      const double gap = (change_prob >= 1) ? 1.0 : 1.0 + std::floor(std::log(1.0 - random.GetDouble()) / log_stay);
+      if (gap >= (double)(end_time - time)) return;
+      time += (size_t)gap;
+      env_changes.emplace_back(Change{time, random.GetUInt(state_cnt)});
+    }
+  }
+
+  /// Regular schedule over [0:end_time): environment changes to a random state every interval time steps.
+  void GenerateRegular(emp::Random & random, size_t interval, size_t state_cnt, size_t end_time) {
+    Reset();
+    for (size_t time = 0; time < end_time; time += interval) {
+      env_changes.emplace_back(Change{time, random.GetUInt(state_cnt)});
+      if (!interval) break;
+    }
+  }
+
+  /// Use other's environment schedule (clearing recorded agent state changes).
+  void SetEnvChanges(const EnvSchedule & other) {
+    env_changes = other.env_changes;
+    agent_changes.clear();
+    next_env_change = 0;
+  }
+
+  /// Clear schedule and recorded agent state changes.
+  void Reset() {
+    env_changes.clear();
+    agent_changes.clear();
+    next_env_change = 0;
+  }
+
+  /// Does the environment change at time? If so, state is set to the new environment state. Call once per
+  /// time step, in time order.
+  bool GetChange(size_t time, size_t & state) {
+    if (next_env_change == env_changes.size() || env_changes[next_env_change].time != time) return false;
+    state = env_changes[next_env_change++].state;
+    return true;
+  }
+
+  /// Record that the agent set its internal state at time (later calls in the same time step win).
+  void RecordAgentState(size_t time, size_t state) {
+    if (agent_changes.size() && agent_changes.back().time == time) agent_changes.back().state = state;
+    else if (agent_changes.empty() || agent_changes.back().state != state) agent_changes.emplace_back(Change{time, state});
+  }
+
+  /// Number of time steps in [0:end_time) in which the agent's state matched the environment's.
+  size_t GetMatchTime(size_t end_time) const {
+    size_t matches = 0;
+    size_t env_id = 0, agent_id = 0;
+    size_t env_state = NO_STATE, agent_state = NO_STATE;
+    for (size_t time = 0; time < end_time; ) {
+      while (env_id < env_changes.size() && env_changes[env_id].time <= time) env_state = env_changes[env_id++].state;
+      while (agent_id < agent_changes.size() && agent_changes[agent_id].time <= time) agent_state = agent_changes[agent_id++].state;
+      size_t next_time = end_time;
+      if (env_id < env_changes.size()) next_time = std::min(next_time, env_changes[env_id].time);
+      if (agent_id < agent_changes.size()) next_time = std::min(next_time, agent_changes[agent_id].time);
+      if (env_state != NO_STATE && env_state == agent_state) matches += next_time - time;
+      time = next_time;
+    }
+    return matches;
+  }
+};
+
+#endif
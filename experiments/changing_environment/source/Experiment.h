@@ -6,9 +6,18 @@
 #include <string>
 #include <utility>
 #include <fstream>
+#include <sstream>
 #include <sys/stat.h>
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <map>
+#include <unordered_set>
+#include <array>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <chrono>
 
 #include "base/Ptr.h"
 #include "base/vector.h"
@@ -28,6 +37,18 @@
 
 #include "l9_chg_env-config.h"
 #include "TaskSet.h"
+#include "EnvSchedule.h"
+#include "FastEventDrivenGP.h"
+#include "AllocCounter.h"
+#include "WorkerPool.h"
+#include "GenomeCodec.h"
+#include "IslandMigrator.h"
+#include "WorldDataFiles.h"
+#include "CompactSystematicsTracker.h"
+#include "MutationalLandscape.h"
+#include "ProgramLoader.h"
+#include "MemoryUsage.h"
+#include "Telemetry.h"
 
 // == Notes ==
 // Things I want to configure:
@@ -40,6 +61,16 @@
 constexpr size_t RUN_ID__EXP = 0;
 constexpr size_t RUN_ID__ANALYSIS = 1;
 
+constexpr size_t ANALYSIS_ID__AGENT = 0;
+constexpr size_t ANALYSIS_ID__SNAPSHOTS = 1;
+constexpr size_t ANALYSIS_ID__LANDSCAPE = 2;
+
+constexpr size_t DATA_FORMAT_ID__CSV = 0;
+constexpr size_t DATA_FORMAT_ID__COLUMNAR = 1;
+
+constexpr size_t SYSTEMATICS_MODE_ID__WORLD = 0;
+constexpr size_t SYSTEMATICS_MODE_ID__COMPACT = 1;
+
 constexpr size_t ENV_TAG_GEN_ID__RANDOM = 0;
 constexpr size_t ENV_TAG_GEN_ID__LOAD = 1;
 
@@ -62,6 +93,8 @@ constexpr size_t MAX_TASK_NUM_INPUTS = 2;
 
 constexpr size_t TASK_CNT = 9;
 
+constexpr size_t ANALYSIS_TRIAL_BATCH = 1024;   ///< Trials evaluated (in parallel) between writes of analysis output.
+
 /// Class to manage ALIFE2018 changing environment (w/logic 9) experiments.
 class Experiment {
 public:
@@ -70,6 +103,9 @@ public:
   // Hardware/agent aliases.
   using hardware_t = emp::EventDrivenGP_AW<TAG_WIDTH>;
   using program_t = hardware_t::Program;
+  using codec_t = GenomeCodec<hardware_t>;
+  using landscape_t = MutationalLandscape<hardware_t>;
+  using program_loader_t = ProgramLoader<hardware_t>;
   using state_t = hardware_t::State;
   using inst_t = hardware_t::inst_t;
   using inst_lib_t = hardware_t::inst_lib_t;
@@ -78,8 +114,14 @@ public:
   using memory_t = hardware_t::memory_t;
   using tag_t = hardware_t::affinity_t;
   using exec_stk_t = hardware_t::exec_stk_t;
+  using fast_hardware_t = FastEventDrivenGP_AW<TAG_WIDTH>;
+  using dispatch_table_t = fast_hardware_t::dispatch_table_t;
+  using shared_program_t = fast_hardware_t::shared_program_t;
+  using shared_program_ptr_t = fast_hardware_t::shared_program_ptr_t;
   // World alias
   using world_t = emp::World<Agent>;
+  using island_migrator_t = IslandMigrator<world_t, codec_t>;
+  using compact_sys_t = CompactSystematicsTracker<world_t, codec_t>;
   // Task aliases
   using task_io_t = uint32_t;
 
@@ -87,16 +129,35 @@ public:
   struct Agent {
     size_t agent_id;
     program_t program;
-
-    Agent(const program_t & _p) : agent_id(0), program(_p) { ; }
-    Agent(const Agent && in) : agent_id(in.GetID()), program(in.program) { ; }
-    Agent(const Agent & in): agent_id(in.GetID()), program(in.program) { ; }
+    shared_program_ptr_t shared_program;  ///< Immutable copy of program for hardware to share; cleared on mutation.
+
+    // Copies (but not moves) count as genome copies (see AllocCounter.h).
+    Agent(const program_t & _p) : agent_id(0), program(_p), shared_program() { CountGenomeCopy(); }
+    Agent(program_t && _p) : agent_id(0), program(std::move(_p)), shared_program() { ; }
+    Agent(Agent && in) = default;
+    Agent(const Agent & in): agent_id(in.GetID()), program(in.program), shared_program(in.shared_program) { CountGenomeCopy(); }
+
+    Agent & operator=(Agent && in) = default;
+    Agent & operator=(const Agent & in) {
+      if (this == &in) return *this;
+      agent_id = in.agent_id;
+      program = in.program;
+      shared_program = in.shared_program;
+      CountGenomeCopy();
+      return *this;
+    }
 
     size_t GetID() const { return agent_id; }
     void SetID(size_t id) { agent_id = id; }
 
     program_t & GetGenome() { return program; }
 
+    /// Get shared (immutable) copy of program, making it (decoded against dispatch table) if necessary.
+    shared_program_ptr_t GetSharedProgram(emp::Ptr<const dispatch_table_t> table) {
+      if (!shared_program) shared_program = std::make_shared<const shared_program_t>(program, table);
+      return shared_program;
+    }
+
   };
 
   class Phenotype {
@@ -164,6 +225,15 @@ public:
 
     size_t GetMinTrial() const { return min_trial; }
 
+    /// Heap bytes held (see MemoryUsage.h).
+    size_t GetMemoryBytes() const {
+      using namespace memory_usage;
+      return VectorBytes(env_match_score_by_trial) + VectorBytes(time_all_tasks_credited_by_trial)
+             + VectorBytes(total_wasted_completions_by_trial) + VectorBytes(unique_tasks_credited_by_trial)
+             + VectorBytes(unique_tasks_completed_by_trial) + VectorBytes(scores_by_trial)
+             + VectorBytes(wasted_completions) + VectorBytes(credited) + VectorBytes(completed);
+    }
+
     size_t GetEnvMatchScore(size_t trialID) const { return env_match_score_by_trial[trialID]; }
     size_t GetTimeAllTasksCredited(size_t trialID) const { return time_all_tasks_credited_by_trial[trialID]; }
     size_t GetTotalWastedCompletions(size_t trialID) const { return total_wasted_completions_by_trial[trialID]; }
@@ -211,6 +281,55 @@ public:
     void IncEnvMatchScore(size_t trialID, size_t amt=1) { env_match_score_by_trial[trialID] += amt; }
   };
 
+  /// Summary statistics over analysis trials, updated one trial at a time.
+  /// Scores are sums of small counts, so they are kept as a histogram: quantiles are exact without
+  /// holding on to every trial.
+  class AnalysisStats {
+  protected:
+    size_t trial_cnt;
+    double score_total;
+    std::map<double, size_t> score_counts;
+    std::array<size_t, TASK_CNT> credited_trials;   ///< By task: trials in which task was credited.
+    std::array<size_t, TASK_CNT> completed_trials;  ///< By task: trials in which task was completed.
+
+  public:
+    AnalysisStats() : trial_cnt(0), score_total(0), score_counts(), credited_trials(), completed_trials() {
+      credited_trials.fill(0);
+      completed_trials.fill(0);
+    }
+
+    void AddTrial(const Phenotype & phen, size_t trialID) {
+      const double score = phen.GetScore(trialID);
+      ++trial_cnt;
+      score_total += score;
+      ++score_counts[score];
+      for (size_t taskID = 0; taskID < TASK_CNT; ++taskID) {
+        if (phen.GetTaskCredited(trialID, taskID)) ++credited_trials[taskID];
+        if (phen.GetTaskCompleted(trialID, taskID)) ++completed_trials[taskID];
+      }
+    }
+
+    size_t GetTrialCnt() const { return trial_cnt; }
+    double GetMean() const { return trial_cnt ? score_total / (double)trial_cnt : 0; }
+    double GetMin() const { return trial_cnt ? score_counts.begin()->first : 0; }
+    double GetMax() const { return trial_cnt ? score_counts.rbegin()->first : 0; }
+
+    /// Nearest-rank quantile (q in [0:1]) of trial scores.
+    double GetQuantile(double q) const {
+      if (!trial_cnt) return 0;
+      const size_t rank = std::max<size_t>(1, (size_t)std::ceil(q * (double)trial_cnt));
+      size_t seen = 0;
+      for (const auto & bin : score_counts) {
+        seen += bin.second;
+        if (seen >= rank) return bin.first;
+      }
+      return GetMax();
+    }
+
+    double GetTaskCreditedRate(size_t taskID) const { return trial_cnt ? (double)credited_trials[taskID] / (double)trial_cnt : 0; }
+    double GetTaskCompletedRate(size_t taskID) const { return trial_cnt ? (double)completed_trials[taskID] / (double)trial_cnt : 0; }
+  };
+
 
 protected:
   // == Configurable experiment parameters ==
@@ -220,6 +339,7 @@ protected:
   size_t GENERATIONS;
   size_t EVAL_TIME;
   size_t TRIAL_CNT;
+  bool SHARED_TRIAL_ENVS;
   bool TASKS_ON;
   std::string ANCESTOR_FPATH;
   size_t SELECTION_METHOD;
@@ -231,6 +351,7 @@ protected:
   size_t ENVIRONMENT_CHANGE_METHOD;
   double ENVIRONMENT_CHANGE_PROB;
   size_t ENVIRONMENT_CHANGE_INTERVAL;
+  bool PRECOMPUTE_ENV_SCHEDULE;
   size_t SGP_PROG_MAX_FUNC_CNT;
   size_t SGP_PROG_MIN_FUNC_CNT;
   size_t SGP_PROG_MAX_FUNC_LEN;
@@ -241,6 +362,8 @@ protected:
   size_t SGP_HW_MAX_CORES;
   size_t SGP_HW_MAX_CALL_DEPTH;
   double SGP_HW_MIN_BIND_THRESH;
+  bool SGP_HW_FAST_DISPATCH;
+  bool SGP_HW_FAST_RESET;
   int SGP__PROG_MAX_ARG_VAL;
   double SGP__PER_BIT__TAG_BFLIP_RATE;
   double SGP__PER_INST__SUB_RATE;
@@ -253,18 +376,55 @@ protected:
   size_t FITNESS_INTERVAL;
   size_t POP_SNAPSHOT_INTERVAL;
   std::string DATA_DIRECTORY;
+  size_t DATA_FILE_FORMAT;
+  size_t SYSTEMATICS_MODE;
+  size_t MEMORY_REPORT_INTERVAL;
+  std::string TELEMETRY_SHM_NAME;
+  size_t ISLAND_CNT;
+  size_t ISLAND_ID;
+  std::string ISLAND_SHM_NAME;
+  size_t ISLAND_MIGRATION_INTERVAL;
+  size_t ISLAND_MIGRANT_CNT;
 
   size_t ANALYSIS;
   std::string ANALYZE_AGENT_FPATH;
+  std::string ANALYZE_SNAPSHOT_FPATHS;
   std::string ANALYSIS_OUTPUT_FNAME;
+  size_t ANALYSIS_THREADS;
+  size_t LANDSCAPE_MUTANT_CNT;
+
+  bool is_analysis_worker;  ///< Evaluates analysis trials on behalf of another experiment.
+  emp::vector<emp::Ptr<Experiment>> analysis_workers; ///< Only used for parallel analysis (ANALYSIS_THREADS != 1).
+  emp::Ptr<WorkerPool> analysis_pool;
 
   emp::Ptr<emp::Random> random;
   emp::Ptr<world_t> world;
 
   emp::Ptr<inst_lib_t> inst_lib;
   emp::Ptr<event_lib_t> event_lib;
+  emp::Ptr<program_loader_t> program_loader;  ///< Loads .gp/.pop files (made once the instruction set is complete).
+
+  emp::Ptr<fast_hardware_t> eval_hw;
+  emp::Ptr<dispatch_table_t> inst_dispatch;   ///< Only used if SGP_HW_FAST_DISPATCH.
+  emp::Ptr<island_migrator_t> island_migrator;  ///< Only used if ISLAND_CNT > 1.
+
+  /// Live stats published to the telemetry page (each generation, right after evaluation).
+  struct TelemetryStats {
+    double best_score;
+    double mean_score;
+    double gens_per_sec;
+    double insts_per_sec;
+    size_t core_steps;                                ///< Hardware core steps (~instructions) run as of last publication.
+    std::chrono::steady_clock::time_point time;       ///< Time of last publication.
+  };
+  emp::Ptr<TelemetryPage> telemetry;                 ///< Only used if TELEMETRY_SHM_NAME is set.
+  TelemetryStats telemetry_stats;
 
-  emp::Ptr<hardware_t> eval_hw;
+  WorldColumnarFiles<world_t> columnar_files;  ///< Only used if DATA_FILE_FORMAT is columnar.
+
+  emp::Ptr<compact_sys_t> compact_sys;        ///< Only used if SYSTEMATICS_MODE is compact.
+
+  memory_usage::ProcMemory proc_memory;               ///< Most recent /proc/self/status sample (for memory file).
 
   emp::vector<tag_t> env_state_tags;  ///< Tags associated with each environment state.
 
@@ -277,12 +437,21 @@ protected:
   size_t eval_trial;
   size_t eval_time;
   size_t env_state;
+  EnvSchedule env_schedule;   ///< Current trial's environment schedule (only used if PRECOMPUTE_ENV_SCHEDULE).
 
   size_t dom_agent_id;
 
   emp::vector<Phenotype> agent_phen_cache;
   emp::vector<double> env_match_proportion_lookup;
 
+  /// Trial environment every agent in a generation is evaluated in (only used if SHARED_TRIAL_ENVS).
+  struct TrialEnv {
+    std::array<task_io_t,MAX_TASK_NUM_INPUTS> task_inputs;
+    taskset_t task_set;         ///< Holds the task solutions for task_inputs.
+    EnvSchedule env_schedule;
+  };
+  emp::vector<TrialEnv> trial_envs;     ///< By trial.
+
   emp::vector<std::function<double(Agent &)>> lexicase_fit_set; ///< Fit set for SGP lexicase selection.
 
   // Run signals.
@@ -307,6 +476,65 @@ protected:
     return (agent_id * TRIAL_CNT) + trial_id;
   }
 
+  /// Reset eval_hw for a new trial. With SGP_HW_FAST_RESET, only the first reset is done the long way;
+  /// its result is saved and restored by later resets (none of this depends on the program).
+  void ResetEvalHardware() {
+    if (SGP_HW_FAST_RESET && eval_hw->HasResetState()) {
+      eval_hw->RestoreResetState();
+      return;
+    }
+    eval_hw->ResetHardware();
+    eval_hw->SetTrait(TRAIT_ID__STATE, -1);
+    eval_hw->SpawnCore(0, memory_t(), true);
+    if (SGP_HW_FAST_RESET) eval_hw->SaveResetState();
+  }
+
+  /// Build this generation's shared trial environments (drawing from the main random number stream, as
+  /// each agent's trials would otherwise).
+  void GenerateTrialEnvs() {
+    trial_envs.resize(TRIAL_CNT);
+    for (TrialEnv & env : trial_envs) {
+      if (env.task_set.GetSize() != task_set.GetSize()) env.task_set = task_set;
+      env.task_inputs.fill(0);
+      env.task_inputs[0] = random->GetUInt(MIN_TASK_INPUT, MAX_TASK_INPUT);
+      env.task_inputs[1] = random->GetUInt(MIN_TASK_INPUT, MAX_TASK_INPUT);
+      env.task_set.SetInputs(env.task_inputs);
+      if (ENVIRONMENT_CHANGE_METHOD == ENV_CHG_ID__RANDOM) {
+        env.env_schedule.GenerateRandom(*random, ENVIRONMENT_CHANGE_PROB, ENVIRONMENT_STATES, EVAL_TIME);
+      } else {
+        env.env_schedule.GenerateRegular(*random, ENVIRONMENT_CHANGE_INTERVAL, ENVIRONMENT_STATES, EVAL_TIME);
+      }
+    }
+  }
+
+  /// Copy of program that uses this experiment's instruction library. (Hardware runs a program with the
+  /// instructions of the library it was made with, and instructions act on their library's experiment.)
+  program_t LocalizeProgram(const program_t & program) const {
+    program_t local_program(inst_lib);
+    for (size_t fp = 0; fp < program.GetSize(); ++fp) local_program.PushFunction(program[fp]);
+    return local_program;
+  }
+
+  /// Shared program (for this experiment's hardware) for one of landscape's evaluations. Knockouts reuse the
+  /// parent's decoded program (local_parent; see SharedProgram).
+  shared_program_ptr_t GetLandscapeProgram(const landscape_t & landscape, size_t eval_id, shared_program_ptr_t local_parent) const {
+    if (eval_id == 0) return local_parent;
+    const auto & variant = landscape.GetEvalVariant(eval_id);
+    const program_t program(LocalizeProgram(landscape.GetProgram(eval_id)));
+    if (variant.type == landscape_t::VARIANT_KNOCKOUT) {
+      return std::make_shared<const shared_program_t>(*local_parent, program, variant.func, variant.inst);
+    }
+    return std::make_shared<const shared_program_t>(program, inst_dispatch);
+  }
+
+  /// Analysis workers: evaluate agent on a single trial (recorded as trial 0) using given random number seed.
+  void EvaluateAnalysisTrial(Agent & agent, int seed) {
+    emp_assert(is_analysis_worker && TRIAL_CNT == 1);
+    random->ResetSeed(seed);
+    agent_phen_cache[agent.GetID()].Reset();
+    Evaluate(agent);
+  }
+
   void Evaluate(Agent & agent) {
     for (eval_trial = 0; eval_trial < TRIAL_CNT; ++eval_trial) {
       env_state = (size_t)-1;
@@ -323,8 +551,13 @@ protected:
   }
 
 public:
-  Experiment(const L9ChgEnvConfig & config)
-    : input_load_id(0), update(0), eval_trial(0), eval_time(0), env_state(0), dom_agent_id(0)
+  /// If analysis_parent is given, this experiment is only used to evaluate the parent's analysis trials
+  /// (one at a time; see EvaluateAnalysisTrial).
+  Experiment(const L9ChgEnvConfig & config, emp::Ptr<const Experiment> analysis_parent=nullptr)
+    : is_analysis_worker(analysis_parent != nullptr), analysis_workers(), analysis_pool(nullptr),
+      inst_dispatch(nullptr), island_migrator(nullptr),
+      telemetry(nullptr), telemetry_stats{0, 0, 0, 0, 0, std::chrono::steady_clock::now()}, columnar_files(),
+      compact_sys(nullptr), input_load_id(0), update(0), eval_trial(0), eval_time(0), env_state(0), env_schedule(), dom_agent_id(0)
   {
     RUN_MODE = config.RUN_MODE();
     RANDOM_SEED = config.RANDOM_SEED();
@@ -332,6 +565,7 @@ public:
     GENERATIONS = config.GENERATIONS();
     EVAL_TIME = config.EVAL_TIME();
     TRIAL_CNT = config.TRIAL_CNT();
+    SHARED_TRIAL_ENVS = config.SHARED_TRIAL_ENVS();
     TASKS_ON = config.TASKS_ON();
     ANCESTOR_FPATH = config.ANCESTOR_FPATH();
     SELECTION_METHOD = config.SELECTION_METHOD();
@@ -343,6 +577,7 @@ public:
     ENVIRONMENT_CHANGE_METHOD = config.ENVIRONMENT_CHANGE_METHOD();
     ENVIRONMENT_CHANGE_PROB = config.ENVIRONMENT_CHANGE_PROB();
     ENVIRONMENT_CHANGE_INTERVAL = config.ENVIRONMENT_CHANGE_INTERVAL();
+    PRECOMPUTE_ENV_SCHEDULE = config.PRECOMPUTE_ENV_SCHEDULE();
     SGP_PROG_MAX_FUNC_CNT = config.SGP_PROG_MAX_FUNC_CNT();
     SGP_PROG_MIN_FUNC_CNT = config.SGP_PROG_MIN_FUNC_CNT();
     SGP_PROG_MAX_FUNC_LEN = config.SGP_PROG_MAX_FUNC_LEN();
@@ -353,6 +588,8 @@ public:
     SGP_HW_MAX_CORES = config.SGP_HW_MAX_CORES();
     SGP_HW_MAX_CALL_DEPTH = config.SGP_HW_MAX_CALL_DEPTH();
     SGP_HW_MIN_BIND_THRESH = config.SGP_HW_MIN_BIND_THRESH();
+    SGP_HW_FAST_DISPATCH = config.SGP_HW_FAST_DISPATCH();
+    SGP_HW_FAST_RESET = config.SGP_HW_FAST_RESET();
     SGP__PROG_MAX_ARG_VAL = config.SGP__PROG_MAX_ARG_VAL();
     SGP__PER_BIT__TAG_BFLIP_RATE = config.SGP__PER_BIT__TAG_BFLIP_RATE();
     SGP__PER_INST__SUB_RATE = config.SGP__PER_INST__SUB_RATE();
@@ -365,9 +602,30 @@ public:
     FITNESS_INTERVAL = config.FITNESS_INTERVAL();
     POP_SNAPSHOT_INTERVAL = config.POP_SNAPSHOT_INTERVAL();
     DATA_DIRECTORY = config.DATA_DIRECTORY();
+    DATA_FILE_FORMAT = config.DATA_FILE_FORMAT();
+    SYSTEMATICS_MODE = config.SYSTEMATICS_MODE();
+    MEMORY_REPORT_INTERVAL = config.MEMORY_REPORT_INTERVAL();
+    TELEMETRY_SHM_NAME = config.TELEMETRY_SHM_NAME();
+    ISLAND_CNT = config.ISLAND_CNT();
+    ISLAND_ID = config.ISLAND_ID();
+    ISLAND_SHM_NAME = config.ISLAND_SHM_NAME();
+    ISLAND_MIGRATION_INTERVAL = config.ISLAND_MIGRATION_INTERVAL();
+    ISLAND_MIGRANT_CNT = config.ISLAND_MIGRANT_CNT();
     ANALYSIS = config.ANALYSIS();
     ANALYZE_AGENT_FPATH = config.ANALYZE_AGENT_FPATH();
+    ANALYZE_SNAPSHOT_FPATHS = config.ANALYZE_SNAPSHOT_FPATHS();
     ANALYSIS_OUTPUT_FNAME = config.ANALYSIS_OUTPUT_FNAME();
+    ANALYSIS_THREADS = config.ANALYSIS_THREADS();
+    LANDSCAPE_MUTANT_CNT = config.LANDSCAPE_MUTANT_CNT();
+
+    // Shared trial environments are built per generation (and need precomputed environment schedules).
+    if (RUN_MODE != RUN_ID__EXP) SHARED_TRIAL_ENVS = false;
+    if (SHARED_TRIAL_ENVS) PRECOMPUTE_ENV_SCHEDULE = true;
+
+    if (is_analysis_worker) {
+      // Workers evaluate one trial at a time, each with its own seed.
+      TRIAL_CNT = 1;
+    }
 
     if (RUN_MODE == RUN_ID__EXP) {
       // Make data directory.
@@ -382,7 +640,8 @@ public:
     // Make the random number generator.
     random = emp::NewPtr<emp::Random>(RANDOM_SEED);
     // Configure environment tags.
-    switch (ENVIRONMENT_TAG_GENERATION_METHOD) {
+    if (is_analysis_worker) env_state_tags = analysis_parent->env_state_tags;
+    else switch (ENVIRONMENT_TAG_GENERATION_METHOD) {
       case ENV_TAG_GEN_ID__RANDOM:
         GenerateEnvTags_Random();
         break;
@@ -393,9 +652,15 @@ public:
         std::cout << "Unrecognized tag generation method!" << std::endl;
         exit(-1);
     }
+    // Islands share environment tags, but each gets its own seed from here on.
+    if (ISLAND_CNT > 1) random->ResetSeed(RANDOM_SEED + (int)ISLAND_ID);
     // Make the world!
     world = emp::NewPtr<world_t>(random, "L9-CE-World");
-    for (size_t i = 0; i < POP_SIZE; ++i) agent_phen_cache.emplace_back(TRIAL_CNT);
+    // Compact systematics replace the world's systematics manager (which would keep a genome per taxon).
+    if (SYSTEMATICS_MODE == SYSTEMATICS_MODE_ID__COMPACT) world->RemoveSystematics(0);
+    // (Parallel analysis records trials in its workers' phenotypes.)
+    const size_t phen_trial_cnt = (RUN_MODE == RUN_ID__ANALYSIS && ANALYSIS_THREADS != 1) ? 1 : TRIAL_CNT;
+    for (size_t i = 0; i < POP_SIZE; ++i) agent_phen_cache.emplace_back(phen_trial_cnt);
     // Make inst/event libraries.
     inst_lib = emp::NewPtr<inst_lib_t>();
     event_lib = emp::NewPtr<event_lib_t>();
@@ -412,6 +677,16 @@ public:
         Config_Analysis();
         break;
     }
+    // Make workers (each with its own hardware, tasks, and random number generator) for parallel analysis.
+    if (RUN_MODE == RUN_ID__ANALYSIS && ANALYSIS_THREADS != 1 && !is_analysis_worker) {
+      size_t thread_cnt = ANALYSIS_THREADS;
+      if (thread_cnt == 0) thread_cnt = std::max<size_t>(1, std::thread::hardware_concurrency());
+      #if defined(EMP_TRACK_MEM) || defined(EMP_MEM_TRACK)
+      thread_cnt = 1; // Memory tracking is not thread safe.
+      #endif
+      analysis_pool = emp::NewPtr<WorkerPool>(thread_cnt);
+      for (size_t i = 0; i < thread_cnt; ++i) analysis_workers.emplace_back(emp::NewPtr<Experiment>(config, this));
+    }
   }
 
   void Run() {
@@ -422,6 +697,10 @@ public:
           RunStep();
           if (update % POP_SNAPSHOT_INTERVAL == 0) do_pop_snapshot_sig.Trigger(update);
         }
+        if (island_migrator) island_migrator->Close();
+        if (telemetry) telemetry.Delete();
+        columnar_files.Clear();
+        if (compact_sys) compact_sys.Delete();
         break;
       case RUN_ID__ANALYSIS:
         do_analysis_sig.Trigger();
@@ -434,15 +713,27 @@ public:
 
   void RunStep() {
     do_evaluation_sig.Trigger();
+    const size_t genome_copy_cnt = GetGenomeCopyCnt();
     do_selection_sig.Trigger();
+    const size_t repro_genome_copy_cnt = GetGenomeCopyCnt() - genome_copy_cnt;
+    if (ALLOC_COUNTER_ENABLED) std::cout << "Genome copies during reproduction: " << repro_genome_copy_cnt << std::endl;
     do_world_update_sig.Trigger();
+    // Selection births offspring through the world, which copies each from its parent's genome; check that
+    // nothing else copies genomes on the way (at most one copy per offspring, now the population).
+    emp_assert(repro_genome_copy_cnt <= world->GetSize(), repro_genome_copy_cnt, world->GetSize());
   }
 
   void Config_Tasks();
   void Config_HW();
+  void Config_Dispatch();
   void Config_Run();
+  void Config_Environment();
   void Config_Analysis();
 
+  void LoadSnapshot_SingleFile(const std::string & fpath, emp::vector<program_t> & programs);
+  void Analysis_Snapshots();
+  void Analysis_Landscape();
+
   size_t Mutate(Agent & agent, emp::Random & rnd);
   double CalcFitness(Agent & agent) {
     return agent_phen_cache[agent.GetID()].GetMinScore();
@@ -450,8 +741,20 @@ public:
 
   void InitPopulation_FromAncestorFile();
   void Snapshot_SingleFile(size_t update);
+  void Migrate();
 
   emp::DataFile & AddDominantFile(const std::string & fpath="dominant.csv");
+  template <typename DATA_FILE>
+  DATA_FILE & AddDominantColumns(DATA_FILE & file);
+
+  emp::DataFile & AddMemoryFile(const std::string & fpath="memory.csv");
+  void SetupTelemetry();
+  void PublishTelemetry(double best_score, double mean_score);
+  size_t GetCoreStepCnt() const;
+  size_t GetWorldMemoryBytes();
+  size_t GetSystematicsMemoryBytes();
+  size_t GetPhenCacheMemoryBytes() const;
+  size_t GetHardwareMemoryBytes() const;
 
   void GenerateEnvTags_Load();
   void GenerateEnvTags_Random();
@@ -474,18 +777,21 @@ public:
   void Inst_Load2(hardware_t & hw, const inst_t & inst);
   void Inst_Submit(hardware_t & hw, const inst_t & inst);
 
+  // Instruction families (fast dispatch versions of SetState-i/SenseState-i; param = i).
+  static void Inst_SetState(Experiment & exp, size_t state_id, hardware_t & hw, const inst_t & inst);
+  static void Inst_SenseState(Experiment & exp, size_t state_id, hardware_t & hw, const inst_t & inst);
+  static void Inst_SenseState_Inactive(Experiment & exp, size_t state_id, hardware_t & hw, const inst_t & inst) { return; }
+
 };
 
 void Experiment::InitPopulation_FromAncestorFile() {
   std::cout << "Initializing population from ancestor file!" << std::endl;
   // Configure the ancestor program.
   program_t ancestor_prog(inst_lib);
-  std::ifstream ancestor_fstream(ANCESTOR_FPATH);
-  if (!ancestor_fstream.is_open()) {
-    std::cout << "Failed to open ancestor program file(" << ANCESTOR_FPATH << "). Exiting..." << std::endl;
+  if (!program_loader->LoadFile(ANCESTOR_FPATH, ancestor_prog)) {
+    std::cout << "Failed to load ancestor program file (" << program_loader->GetError() << "). Exiting..." << std::endl;
     exit(-1);
   }
-  ancestor_prog.Load(ancestor_fstream);
   std::cout << " --- Ancestor program: ---" << std::endl;
   ancestor_prog.PrintProgramFull();
   std::cout << " -------------------------" << std::endl;
@@ -555,6 +861,16 @@ void Experiment::GenerateEnvTags_Random() {
   }
 }
 
+/// Island model: send ISLAND_MIGRANT_CNT randomly chosen agents to the next island, and replace randomly
+/// chosen agents with migrants from the previous island.
+void Experiment::Migrate() {
+  program_t immigrant(inst_lib);
+  if (!island_migrator->Migrate(*world, *random, immigrant, [this](size_t pos) { if (compact_sys) compact_sys->TrackInjection(pos); }, std::cout)) {
+    std::cout << "Exiting..." << std::endl;
+    exit(-1);
+  }
+}
+
 void Experiment::Snapshot_SingleFile(size_t update) {
   std::string snapshot_dir = DATA_DIRECTORY + "pop_" + emp::to_string((int)update);
   mkdir(snapshot_dir.c_str(), ACCESSPERMS);
@@ -571,7 +887,14 @@ void Experiment::Snapshot_SingleFile(size_t update) {
 /// Setup a data_file with world that records information about the dominant genotype.
 emp::DataFile & Experiment::AddDominantFile(const std::string & fpath) {
     auto & file = world->SetupFile(fpath);
+    AddDominantColumns(file);
+    file.PrintHeaderKeys();
+    return file;
+}
 
+/// Add columns that describe the dominant genotype to file (an emp::DataFile or a ColumnarFile).
+template <typename DATA_FILE>
+DATA_FILE & Experiment::AddDominantColumns(DATA_FILE & file) {
     std::function<size_t(void)> get_update = [this](){ return world->GetUpdate(); };
     file.AddFun(get_update, "update", "Update");
 
@@ -630,16 +953,138 @@ emp::DataFile & Experiment::AddDominantFile(const std::string & fpath) {
       };
       file.AddFun(get_credited, "credited_"+task_set.GetName(i), "...");
     }
-    file.PrintHeaderKeys();
     return file;
 }
 
+/// Memory file: estimated bytes held by each major subsystem (see MemoryUsage.h), plus the process's
+/// current and peak resident set size.
+emp::DataFile & Experiment::AddMemoryFile(const std::string & fpath) {
+  auto & file = world->SetupFile(fpath);
+  std::function<size_t(void)> get_update = [this](){ return world->GetUpdate(); };
+  file.AddFun(get_update, "update", "Update");
+  std::function<size_t(void)> get_world_bytes = [this]() { return this->GetWorldMemoryBytes(); };
+  file.AddFun(get_world_bytes, "world_bytes", "Population: agents, their programs, and their shared (decoded) programs");
+  std::function<size_t(void)> get_sys_bytes = [this]() { return this->GetSystematicsMemoryBytes(); };
+  if (SYSTEMATICS_MODE == SYSTEMATICS_MODE_ID__COMPACT) {
+    file.AddFun(get_sys_bytes, "systematics_bytes", "Systematics (compact systematics)");
+  } else {
+    file.AddFun(get_sys_bytes, "systematics_bytes_est", "Systematics (world systematics manager, estimated from taxon count)");
+  }
+  std::function<size_t(void)> get_phen_bytes = [this]() { return this->GetPhenCacheMemoryBytes(); };
+  file.AddFun(get_phen_bytes, "phen_cache_bytes", "Phenotype cache (agent_phen_cache)");
+  std::function<size_t(void)> get_hw_bytes = [this]() { return this->GetHardwareMemoryBytes(); };
+  file.AddFun(get_hw_bytes, "hardware_bytes", "Evaluation hardware");
+  std::function<size_t(void)> get_rss = [this]() { proc_memory = memory_usage::ReadProcMemory(); return proc_memory.rss; };
+  file.AddFun(get_rss, "rss_bytes", "Resident set size");
+  std::function<size_t(void)> get_peak_rss = [this]() { return proc_memory.peak_rss; };
+  file.AddFun(get_peak_rss, "peak_rss_bytes", "Peak resident set size");
+  file.PrintHeaderKeys();
+  return file;
+}
+
+/// Telemetry page (see Telemetry.h): run progress and throughput, population score (agents are scored
+/// by their worst trial), and the dominant agent's phenotype (in its worst trial).
+void Experiment::SetupTelemetry() {
+  telemetry = emp::NewPtr<TelemetryPage>(TELEMETRY_SHM_NAME);
+  telemetry->AddStat("update", [this]() { return (double)update; });
+  telemetry->AddStat("gens_per_sec", [this]() { return telemetry_stats.gens_per_sec; });
+  telemetry->AddStat("insts_per_sec", [this]() { return telemetry_stats.insts_per_sec; });
+  telemetry->AddStat("best_score", [this]() { return telemetry_stats.best_score; });
+  telemetry->AddStat("mean_score", [this]() { return telemetry_stats.mean_score; });
+  telemetry->AddStat("dom_id", [this]() { return (double)dom_agent_id; });
+  telemetry->AddStat("dom_env_match_score", [this]() {
+    const Phenotype & phen = agent_phen_cache[dom_agent_id];
+    return (double)phen.GetEnvMatchScore(phen.GetMinTrial());
+  });
+  telemetry->AddStat("dom_unique_tasks_credited", [this]() {
+    const Phenotype & phen = agent_phen_cache[dom_agent_id];
+    return (double)phen.GetUniqueTasksCredited(phen.GetMinTrial());
+  });
+  telemetry->AddStat("dom_inst_cnt", [this]() { return (double)world->GetOrg(dom_agent_id).GetGenome().GetInstCnt(); });
+  telemetry->AddStat("rss_bytes", []() { return (double)memory_usage::ReadProcMemory().rss; });
+  if (!telemetry->Open(std::cout)) {
+    std::cout << "Failed to create telemetry page (" << TELEMETRY_SHM_NAME << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  telemetry_stats.core_steps = GetCoreStepCnt();
+  telemetry_stats.time = std::chrono::steady_clock::now();
+}
+
+/// Update throughput (since the last publication) and publish stats to the telemetry page.
+void Experiment::PublishTelemetry(double best_score, double mean_score) {
+  const auto now = std::chrono::steady_clock::now();
+  const double secs = std::chrono::duration<double>(now - telemetry_stats.time).count();
+  const size_t core_steps = GetCoreStepCnt();
+  telemetry_stats.best_score = best_score;
+  telemetry_stats.mean_score = mean_score;
+  telemetry_stats.gens_per_sec = (secs > 0) ? 1.0 / secs : 0;
+  telemetry_stats.insts_per_sec = (secs > 0) ? (double)(core_steps - telemetry_stats.core_steps) / secs : 0;
+  telemetry_stats.core_steps = core_steps;
+  telemetry_stats.time = now;
+  telemetry->Publish();
+}
+
+/// Core steps run by evaluation hardware so far.
+size_t Experiment::GetCoreStepCnt() const {
+  return eval_hw->GetCoreStepCnt();
+}
+
+/// Bytes held by the population (shared programs are counted once, however many agents share them).
+size_t Experiment::GetWorldMemoryBytes() {
+  std::unordered_set<const shared_program_t *> shared;
+  size_t bytes = world->GetSize() * sizeof(emp::Ptr<Agent>);
+  for (size_t id = 0; id < world->GetSize(); ++id) {
+    if (!world->IsOccupied(id)) continue;
+    const Agent & agent = world->GetOrg(id);
+    bytes += sizeof(Agent) + memory_usage::ProgramBytes(agent.program);
+    if (agent.shared_program && shared.insert(agent.shared_program.get()).second) {
+      bytes += sizeof(shared_program_t) + agent.shared_program->GetMemoryBytes();
+    }
+  }
+  return bytes;
+}
+
+/// Bytes held by systematics. Compact systematics report their own size. The world's systematics manager
+/// keeps a taxon (with a copy of its genome) for every genotype it tracks; its size is estimated from the
+/// taxon count and the population's mean program size.
+size_t Experiment::GetSystematicsMemoryBytes() {
+  if (compact_sys) return compact_sys->GetMemoryBytes();
+  size_t prog_bytes = 0;
+  for (size_t id = 0; id < world->GetSize(); ++id) {
+    if (world->IsOccupied(id)) prog_bytes += memory_usage::ProgramBytes(world->GetOrg(id).program);
+  }
+  if (world->GetSize()) prog_bytes /= world->GetSize();
+  return world->GetSystematics().GetNumTaxa() * (memory_usage::TAXON_BYTES + sizeof(program_t) + prog_bytes);
+}
+
+size_t Experiment::GetPhenCacheMemoryBytes() const {
+  size_t bytes = memory_usage::VectorBytes(agent_phen_cache);
+  for (const Phenotype & phen : agent_phen_cache) bytes += phen.GetMemoryBytes();
+  return bytes;
+}
+
+size_t Experiment::GetHardwareMemoryBytes() const {
+  return sizeof(fast_hardware_t) + eval_hw->GetMemoryBytes();
+}
+
 void Experiment::Config_Run() {
   world->Reset();
   world->SetWellMixed(true);
   world->SetMutFun([this](Agent & agent, emp::Random & rnd) { return this->Mutate(agent, rnd); }, ELITE_SELECT__ELITE_CNT);
   world->SetFitFun([this](Agent & agent) { return this->CalcFitness(agent); });
 
+  // Join island ring (island model).
+  if (ISLAND_CNT > 1) {
+    island_migrator = emp::NewPtr<island_migrator_t>(ISLAND_SHM_NAME, ISLAND_CNT, ISLAND_ID, ISLAND_MIGRANT_CNT,
+                                                     codec_t::GetMaxBytes(SGP_PROG_MAX_FUNC_CNT, SGP_PROG_MAX_TOTAL_LEN));
+    if (!island_migrator->Open(std::cout)) {
+      std::cout << "Failed to join island ring (" << ISLAND_SHM_NAME << "). Exiting..." << std::endl;
+      exit(-1);
+    }
+  }
+  // Publish live stats (telemetry page).
+  if (TELEMETRY_SHM_NAME != "") this->SetupTelemetry();
+
   // Save out env tags in use if randomly generated
   if (ENVIRONMENT_TAG_GENERATION_METHOD != ENV_TAG_GEN_ID__LOAD) { SaveEnvTags(); }
   // Print tags
@@ -674,39 +1119,83 @@ void Experiment::Config_Run() {
   do_begin_run_setup_sig.AddAction([this]() {
     std::cout << "Doing initial run setup." << std::endl;
     // Setup systematics/fitness tracking.
-    auto & sys_file = world->SetupSystematicsFile(DATA_DIRECTORY + "systematics.csv");
-    sys_file.SetTimingRepeat(SYSTEMATICS_INTERVAL);
-    auto & fit_file = world->SetupFitnessFile(DATA_DIRECTORY + "fitness.csv");
-    fit_file.SetTimingRepeat(FITNESS_INTERVAL);
-    this->AddDominantFile(DATA_DIRECTORY + "dominant.csv").SetTimingRepeat(SYSTEMATICS_INTERVAL);
+    if (SYSTEMATICS_MODE == SYSTEMATICS_MODE_ID__COMPACT) {
+      const bool columnar = DATA_FILE_FORMAT == DATA_FORMAT_ID__COLUMNAR;
+      compact_sys = emp::NewPtr<compact_sys_t>(*world, DATA_DIRECTORY + (columnar ? "systematics.sgpcol" : "systematics.csv"),
+                                               columnar, SYSTEMATICS_INTERVAL);
+    } else if (DATA_FILE_FORMAT == DATA_FORMAT_ID__COLUMNAR) {
+      columnar_files.AddSystematicsFile(*world, DATA_DIRECTORY + "systematics.sgpcol").SetTimingRepeat(SYSTEMATICS_INTERVAL);
+    } else {
+      auto & sys_file = world->SetupSystematicsFile(DATA_DIRECTORY + "systematics.csv");
+      sys_file.SetTimingRepeat(SYSTEMATICS_INTERVAL);
+    }
+    if (DATA_FILE_FORMAT == DATA_FORMAT_ID__COLUMNAR) {
+      columnar_files.AddFitnessFile(*world, DATA_DIRECTORY + "fitness.sgpcol").SetTimingRepeat(FITNESS_INTERVAL);
+      this->AddDominantColumns(columnar_files.Add(DATA_DIRECTORY + "dominant.sgpcol")).SetTimingRepeat(SYSTEMATICS_INTERVAL);
+      if (!columnar_files.IsGood(std::cout)) {
+        std::cout << "Exiting..." << std::endl;
+        exit(-1);
+      }
+    } else {
+      auto & fit_file = world->SetupFitnessFile(DATA_DIRECTORY + "fitness.csv");
+      fit_file.SetTimingRepeat(FITNESS_INTERVAL);
+      this->AddDominantFile(DATA_DIRECTORY + "dominant.csv").SetTimingRepeat(SYSTEMATICS_INTERVAL);
+    }
+    if (MEMORY_REPORT_INTERVAL) this->AddMemoryFile(DATA_DIRECTORY + "memory.csv").SetTimingRepeat(MEMORY_REPORT_INTERVAL);
     // Generate the initial population.
     do_pop_init_sig.Trigger();
+    if (compact_sys) {
+      for (size_t pos = 0; pos < world->GetSize(); ++pos) compact_sys->TrackInjection(pos);
+    }
   });
 
   // Do evaluation action
   do_evaluation_sig.AddAction([this]() {
     double best_score = -32767;
+    double total_score = 0;
+    size_t eval_alloc_cnt = 0;
     dom_agent_id = 0;
+    if (SHARED_TRIAL_ENVS) this->GenerateTrialEnvs();
     for (size_t id = 0; id < world->GetSize(); ++id) {
       Agent & our_hero = world->GetOrg(id);
       our_hero.SetID(id);
-      eval_hw->SetProgram(our_hero.GetGenome());
+      eval_hw->SetProgram(our_hero.GetSharedProgram(inst_dispatch));
       // Reset cache values.
       agent_phen_cache[id].Reset();
+      const size_t alloc_cnt = GetAllocCnt();
       this->Evaluate(our_hero);
+      eval_alloc_cnt += GetAllocCnt() - alloc_cnt;
       // Find min trial.
       agent_phen_cache[id].SetMinTrial();
       // -- Keep track of worst-type phenotype & cur phenotype;
       if (agent_phen_cache[id].GetMinScore() > best_score) { best_score = agent_phen_cache[id].GetMinScore(); dom_agent_id = id; }
+      total_score += agent_phen_cache[id].GetMinScore();
+    }
+    if (ALLOC_COUNTER_ENABLED) std::cout << "Heap allocations during evaluation: " << eval_alloc_cnt << std::endl;
+    // With hardware run-time state in arenas, evaluation must not touch the heap once the first update has
+    // sized the arenas' free lists and the hardware's containers.
+    if (ALLOC_COUNTER_ENABLED && TRIAL_ARENA_ENABLED && update > 0 && eval_alloc_cnt) {
+      std::cout << "Heap allocations during evaluation after warm-up (expected 0): " << eval_alloc_cnt << ". Exiting..." << std::endl;
+      exit(-1);
     }
     std::cout << "Update: " << update << " Max score: " << best_score << std::endl;
+    if (telemetry) this->PublishTelemetry(best_score, world->GetSize() ? total_score / (double)world->GetSize() : 0);
   });
 
   // Do world update action
   do_world_update_sig.AddAction([this]() {
+    columnar_files.Update(*world);
     world->Update();
+    if (compact_sys) compact_sys->Track();
   });
 
+  // Island model: migrate right after population turnover.
+  if (island_migrator && ISLAND_MIGRATION_INTERVAL) {
+    do_world_update_sig.AddAction([this]() {
+      if (update && update % ISLAND_MIGRATION_INTERVAL == 0) this->Migrate();
+    });
+  }
+
   // Do population snapshot action
   do_pop_snapshot_sig.AddAction([this](size_t update) { this->Snapshot_SingleFile(update); });
 
@@ -775,20 +1264,24 @@ void Experiment::Config_Run() {
   // Begin eval trial action
   begin_trial_sig.AddAction([this](Agent & agent) {
     // 1) Reset tasks.
-    task_inputs[0] = random->GetUInt(MIN_TASK_INPUT, MAX_TASK_INPUT);
-    task_inputs[1] = random->GetUInt(MIN_TASK_INPUT, MAX_TASK_INPUT);
     input_load_id = 0;
-    task_set.SetInputs(task_inputs);
+    if (SHARED_TRIAL_ENVS) {
+      task_inputs = trial_envs[eval_trial].task_inputs;
+      task_set.SetSolutions(trial_envs[eval_trial].task_set);
+    } else {
+      task_inputs[0] = random->GetUInt(MIN_TASK_INPUT, MAX_TASK_INPUT);
+      task_inputs[1] = random->GetUInt(MIN_TASK_INPUT, MAX_TASK_INPUT);
+      task_set.SetInputs(task_inputs);
+    }
     // 2) Reset hardware
-    eval_hw->ResetHardware();
-    eval_hw->SetTrait(TRAIT_ID__STATE, -1);
-    eval_hw->SpawnCore(0, memory_t(), true);
+    this->ResetEvalHardware();
   });
 
   record_cur_phenotype_sig.AddAction([this](Agent & agent) {
     const size_t agent_id = agent.GetID();
     Phenotype & phen = agent_phen_cache[agent_id];
     // Record everything that can only be recorded pos-trial.
+    if (PRECOMPUTE_ENV_SCHEDULE) phen.SetEnvMatchScore(eval_trial, env_schedule.GetMatchTime(EVAL_TIME));
     phen.SetScore(eval_trial, calc_score(agent));
     // std::cout << "  Score: " << phen.GetScore(eval_trial) << std::endl;
     phen.SetTimeAllTasksCredited(eval_trial, task_set.GetAllTasksCreditedTime());
@@ -802,6 +1295,36 @@ void Experiment::Config_Run() {
     }
   });
 
+  Config_Environment();
+}
+
+/// Environment (and agent advance) actions. Per-step: the environment changes with probability
+/// ENVIRONMENT_CHANGE_PROB (or every ENVIRONMENT_CHANGE_INTERVAL steps), and the agent's state is compared
+/// to the environment's after every step. With PRECOMPUTE_ENV_SCHEDULE, each trial's schedule is generated
+/// when the trial begins (or, with SHARED_TRIAL_ENVS, taken from the generation's trial environments) and
+/// env matches are counted from state intervals when it ends (see EnvSchedule).
+void Experiment::Config_Environment() {
+  if (ENVIRONMENT_CHANGE_METHOD != ENV_CHG_ID__RANDOM && ENVIRONMENT_CHANGE_METHOD != ENV_CHG_ID__REGULAR) {
+    std::cout << "Unrecognized environment change method. Exiting..." << std::endl;
+    exit(-1);
+  }
+  if (PRECOMPUTE_ENV_SCHEDULE) {
+    begin_trial_sig.AddAction([this](Agent & agent) {
+      if (SHARED_TRIAL_ENVS) {
+        env_schedule.SetEnvChanges(trial_envs[eval_trial].env_schedule);
+      } else if (ENVIRONMENT_CHANGE_METHOD == ENV_CHG_ID__RANDOM) {
+        env_schedule.GenerateRandom(*random, ENVIRONMENT_CHANGE_PROB, ENVIRONMENT_STATES, EVAL_TIME);
+      } else {
+        env_schedule.GenerateRegular(*random, ENVIRONMENT_CHANGE_INTERVAL, ENVIRONMENT_STATES, EVAL_TIME);
+      }
+    });
+    env_advance_sig.AddAction([this]() {
+      if (env_schedule.GetChange(eval_time, env_state)) eval_hw->TriggerEvent("EnvSignal", env_state_tags[env_state]);
+    });
+    agent_advance_sig.AddAction([this](Agent & agent) { eval_hw->SingleProcess(); });
+    return;
+  }
+
   // Advance agent action
   agent_advance_sig.AddAction([this](Agent & agent) {
     const size_t agent_id = agent.GetID();
@@ -834,29 +1357,19 @@ void Experiment::Config_Run() {
         }
       });
       break;
-    default:
-      std::cout << "Unrecognized environment change method. Exiting..." << std::endl;
-      exit(-1);
   }
 }
 
 void Experiment::Config_Analysis() {
   // Print tags
-  std::cout << "Environment states: " << std::endl;
-  for (size_t i = 0; i < env_state_tags.size(); ++i) {
-    int tag_int = env_state_tags[i].GetUInt(0);
-    std::cout << "[" << i << "]: "; env_state_tags[i].Print(); std::cout << "(" << tag_int << ")" << std::endl;
-  }
-  std::cout << "--" << std::endl;
-
-  // Advance agent action
-  agent_advance_sig.AddAction([this](Agent & agent) {
-    const size_t agent_id = agent.GetID();
-    eval_hw->SingleProcess();
-    if ((size_t)eval_hw->GetTrait(TRAIT_ID__STATE) == env_state) {
-      agent_phen_cache[agent_id].IncEnvMatchScore(eval_trial);
+  if (!is_analysis_worker) {
+    std::cout << "Environment states: " << std::endl;
+    for (size_t i = 0; i < env_state_tags.size(); ++i) {
+      int tag_int = env_state_tags[i].GetUInt(0);
+      std::cout << "[" << i << "]: "; env_state_tags[i].Print(); std::cout << "(" << tag_int << ")" << std::endl;
     }
-  });
+    std::cout << "--" << std::endl;
+  }
 
   // score: uniques tasks credited + unique tasks completed + (eval time - time took to get full credit) + env matches
   calc_score = [this](Agent & agent) {
@@ -879,15 +1392,14 @@ void Experiment::Config_Analysis() {
     input_load_id = 0;
     task_set.SetInputs(task_inputs);
     // 2) Reset hardware
-    eval_hw->ResetHardware();
-    eval_hw->SetTrait(TRAIT_ID__STATE, -1);
-    eval_hw->SpawnCore(0, memory_t(), true);
+    this->ResetEvalHardware();
   });
 
   record_cur_phenotype_sig.AddAction([this](Agent & agent) {
     const size_t agent_id = agent.GetID();
     Phenotype & phen = agent_phen_cache[agent_id];
     // Record everything that can only be recorded pos-trial.
+    if (PRECOMPUTE_ENV_SCHEDULE) phen.SetEnvMatchScore(eval_trial, env_schedule.GetMatchTime(EVAL_TIME));
     phen.SetScore(eval_trial, calc_score(agent));
     // std::cout << "  Score: " << phen.GetScore(eval_trial) << std::endl;
     phen.SetTimeAllTasksCredited(eval_trial, task_set.GetAllTasksCreditedTime());
@@ -901,69 +1413,249 @@ void Experiment::Config_Analysis() {
     }
   });
 
-  switch (ENVIRONMENT_CHANGE_METHOD) {
-    case ENV_CHG_ID__RANDOM:
-      env_advance_sig.AddAction([this]() {
-        if (env_state == (size_t)-1 || random->P(ENVIRONMENT_CHANGE_PROB)) {
-          // Trigger change!
-          // 1) Change the environment to a random state.
-          env_state = random->GetUInt(ENVIRONMENT_STATES);
-          // 2) Trigger environment state event.
-          eval_hw->TriggerEvent("EnvSignal", env_state_tags[env_state]);
-        }
-      });
-      break;
-    case ENV_CHG_ID__REGULAR:
-      env_advance_sig.AddAction([this]() {
-        if ((eval_time % ENVIRONMENT_CHANGE_INTERVAL) == 0) {
-          // Trigger change!
-          // 1) Change the environment to a random state.
-          env_state = random->GetUInt(ENVIRONMENT_STATES);
-          // 2) Trigger environment state event.
-          eval_hw->TriggerEvent("EnvSignal", env_state_tags[env_state]);
-        }
-      });
-      break;
-    default:
-      std::cout << "Unrecognized environment change method. Exiting..." << std::endl;
-      exit(-1);
-  }
+  Config_Environment();
 
 
+  if (ANALYSIS == ANALYSIS_ID__SNAPSHOTS) {
+    do_analysis_sig.AddAction([this]() { this->Analysis_Snapshots(); });
+    return;
+  } else if (ANALYSIS == ANALYSIS_ID__LANDSCAPE) {
+    do_analysis_sig.AddAction([this]() { this->Analysis_Landscape(); });
+    return;
+  } else if (ANALYSIS != ANALYSIS_ID__AGENT) {
+    std::cout << "Unrecognized analysis. Exiting..." << std::endl;
+    exit(-1);
+  }
+
   // Run analysis.
   do_analysis_sig.AddAction([this]() {
     program_t analysis_prog(inst_lib);
-    std::ifstream analysis_fstream(ANALYZE_AGENT_FPATH);
-    if (!analysis_fstream.is_open()) {
-      std::cout << "Failed to open ancestor program file(" << ANALYZE_AGENT_FPATH << "). Exiting..." << std::endl;
+    if (!program_loader->LoadFile(ANALYZE_AGENT_FPATH, analysis_prog)) {
+      std::cout << "Failed to load analysis program file (" << program_loader->GetError() << "). Exiting..." << std::endl;
       exit(-1);
     }
 
-    analysis_prog.Load(analysis_fstream);
     std::cout << " --- Analysis program: ---" << std::endl;
     analysis_prog.PrintProgramFull();
 
 
-    Agent our_hero(analysis_prog);
-    our_hero.SetID(0);
-    agent_phen_cache[our_hero.GetID()].Reset();
-    eval_hw->SetProgram(our_hero.GetGenome());
-    this->Evaluate(our_hero);
-
-    // Output stuff to file.
-    // Output shit.
+    AnalysisStats stats;
     std::ofstream prog_ofstream("./"+ANALYSIS_OUTPUT_FNAME);
     // Fill out the header.
     prog_ofstream << "trial,fitness";
-    for (size_t tID = 0; tID < TRIAL_CNT; ++tID) {
-      prog_ofstream << "\n" << tID << "," << agent_phen_cache[our_hero.GetID()].GetScore(tID);
+
+    if (analysis_workers.empty()) {
+      Agent our_hero(analysis_prog);
+      our_hero.SetID(0);
+      agent_phen_cache[our_hero.GetID()].Reset();
+      eval_hw->SetProgram(our_hero.GetSharedProgram(inst_dispatch));
+      this->Evaluate(our_hero);
+
+      // Output stuff to file.
+      for (size_t tID = 0; tID < TRIAL_CNT; ++tID) {
+        prog_ofstream << "\n" << tID << "," << agent_phen_cache[our_hero.GetID()].GetScore(tID);
+        stats.AddTrial(agent_phen_cache[our_hero.GetID()], tID);
+      }
+    } else {
+      // Evaluate trials in parallel, a batch at a time; write each batch out in trial order.
+      // Trial seeds are drawn in trial order, so results do not depend on the number of workers.
+      emp::vector<Agent> heroes;
+      for (size_t w = 0; w < analysis_workers.size(); ++w) {
+        heroes.emplace_back(analysis_workers[w]->LocalizeProgram(analysis_prog));
+        heroes[w].SetID(0);
+        analysis_workers[w]->eval_hw->SetProgram(heroes[w].GetSharedProgram(analysis_workers[w]->inst_dispatch));
+      }
+      emp::vector<int> batch_seeds(ANALYSIS_TRIAL_BATCH);
+      emp::vector<Phenotype> batch_phens(ANALYSIS_TRIAL_BATCH, Phenotype(1));
+      for (size_t first_trial = 0; first_trial < TRIAL_CNT; first_trial += ANALYSIS_TRIAL_BATCH) {
+        const size_t batch_cnt = std::min(ANALYSIS_TRIAL_BATCH, TRIAL_CNT - first_trial);
+        for (size_t i = 0; i < batch_cnt; ++i) batch_seeds[i] = random->GetInt(1, 2000000000);
+        std::atomic<size_t> next_trial(0);
+        analysis_pool->Run(analysis_workers.size(), [this, &heroes, &batch_seeds, &batch_phens, &next_trial, batch_cnt](size_t w) {
+          Experiment & worker = *analysis_workers[w];
+          for (size_t i = next_trial++; i < batch_cnt; i = next_trial++) {
+            worker.EvaluateAnalysisTrial(heroes[w], batch_seeds[i]);
+            batch_phens[i] = worker.agent_phen_cache[heroes[w].GetID()];
+          }
+        });
+        for (size_t i = 0; i < batch_cnt; ++i) {
+          prog_ofstream << "\n" << (first_trial + i) << "," << batch_phens[i].GetScore(0);
+          stats.AddTrial(batch_phens[i], 0);
+        }
+        prog_ofstream.flush();
+      }
     }
     prog_ofstream.close();
 
+    std::cout << " --- Analysis summary (" << stats.GetTrialCnt() << " trials): ---" << std::endl;
+    std::cout << "Fitness: mean=" << stats.GetMean() << " min=" << stats.GetMin()
+              << " q05=" << stats.GetQuantile(0.05) << " q25=" << stats.GetQuantile(0.25)
+              << " median=" << stats.GetQuantile(0.5) << " q75=" << stats.GetQuantile(0.75)
+              << " q95=" << stats.GetQuantile(0.95) << " max=" << stats.GetMax() << std::endl;
+    for (size_t taskID = 0; taskID < task_set.GetSize(); ++taskID) {
+      std::cout << "Task " << task_set.GetName(taskID) << ": credited=" << stats.GetTaskCreditedRate(taskID)
+                << " completed=" << stats.GetTaskCompletedRate(taskID) << std::endl;
+    }
+
   });
 
 }
 
+/// Load every program in a population snapshot file (see Snapshot_SingleFile) into programs.
+void Experiment::LoadSnapshot_SingleFile(const std::string & fpath, emp::vector<program_t> & programs) {
+  if (!program_loader->LoadPopFile(fpath, programs)) {
+    std::cout << "Failed to load population snapshot file (" << program_loader->GetError() << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+}
+
+/// Evaluate every program in each of the population snapshots in ANALYZE_SNAPSHOT_FPATHS (TRIAL_CNT
+/// trials each), writing one row of phenotype summary stats per program. A snapshot's dominant is the
+/// program with the best worst-trial fitness (as during evolution; ties go to the best mean fitness).
+void Experiment::Analysis_Snapshots() {
+  emp::vector<std::string> snapshot_fpaths;
+  emp::slice(ANALYZE_SNAPSHOT_FPATHS, snapshot_fpaths, ',');
+  std::ofstream prog_ofstream("./"+ANALYSIS_OUTPUT_FNAME);
+  prog_ofstream << "snapshot,program,dominant,trials,mean_fitness,min_fitness,median_fitness,max_fitness";
+  for (size_t taskID = 0; taskID < task_set.GetSize(); ++taskID) prog_ofstream << ",credited_" << task_set.GetName(taskID);
+  for (size_t taskID = 0; taskID < task_set.GetSize(); ++taskID) prog_ofstream << ",completed_" << task_set.GetName(taskID);
+  emp::vector<program_t> programs;
+  emp::vector<AnalysisStats> prog_stats;
+  emp::vector<int> trial_seeds;
+  for (const std::string & snapshot_fpath : snapshot_fpaths) {
+    if (snapshot_fpath.empty()) continue;
+    LoadSnapshot_SingleFile(snapshot_fpath, programs);
+    if (programs.empty()) {
+      std::cout << "Snapshot " << snapshot_fpath << ": no programs." << std::endl;
+      continue;
+    }
+    prog_stats.clear();
+    prog_stats.resize(programs.size());
+    if (analysis_workers.empty()) {
+      for (size_t progID = 0; progID < programs.size(); ++progID) {
+        Agent our_hero(programs[progID]);
+        our_hero.SetID(0);
+        agent_phen_cache[our_hero.GetID()].Reset();
+        eval_hw->SetProgram(our_hero.GetSharedProgram(inst_dispatch));
+        this->Evaluate(our_hero);
+        for (size_t tID = 0; tID < TRIAL_CNT; ++tID) prog_stats[progID].AddTrial(agent_phen_cache[our_hero.GetID()], tID);
+      }
+    } else {
+      // Evaluate programs in parallel. Trial seeds are drawn in program/trial order, so results do not
+      // depend on the number of workers.
+      trial_seeds.resize(programs.size() * TRIAL_CNT);
+      for (int & seed : trial_seeds) seed = random->GetInt(1, 2000000000);
+      std::atomic<size_t> next_prog(0);
+      analysis_pool->Run(analysis_workers.size(), [this, &programs, &prog_stats, &trial_seeds, &next_prog](size_t w) {
+        Experiment & worker = *analysis_workers[w];
+        for (size_t progID = next_prog++; progID < programs.size(); progID = next_prog++) {
+          Agent our_hero(worker.LocalizeProgram(programs[progID]));
+          our_hero.SetID(0);
+          worker.eval_hw->SetProgram(our_hero.GetSharedProgram(worker.inst_dispatch));
+          for (size_t tID = 0; tID < TRIAL_CNT; ++tID) {
+            worker.EvaluateAnalysisTrial(our_hero, trial_seeds[progID * TRIAL_CNT + tID]);
+            prog_stats[progID].AddTrial(worker.agent_phen_cache[our_hero.GetID()], 0);
+          }
+        }
+      });
+    }
+    // Find dominant.
+    size_t dom_id = 0;
+    for (size_t progID = 1; progID < programs.size(); ++progID) {
+      const AnalysisStats & stats = prog_stats[progID];
+      const AnalysisStats & dom_stats = prog_stats[dom_id];
+      if (stats.GetMin() > dom_stats.GetMin() || (stats.GetMin() == dom_stats.GetMin() && stats.GetMean() > dom_stats.GetMean())) dom_id = progID;
+    }
+    for (size_t progID = 0; progID < programs.size(); ++progID) {
+      const AnalysisStats & stats = prog_stats[progID];
+      prog_ofstream << "\n" << snapshot_fpath << "," << progID << "," << (progID == dom_id) << "," << stats.GetTrialCnt()
+                    << "," << stats.GetMean() << "," << stats.GetMin() << "," << stats.GetQuantile(0.5) << "," << stats.GetMax();
+      for (size_t taskID = 0; taskID < task_set.GetSize(); ++taskID) prog_ofstream << "," << stats.GetTaskCreditedRate(taskID);
+      for (size_t taskID = 0; taskID < task_set.GetSize(); ++taskID) prog_ofstream << "," << stats.GetTaskCompletedRate(taskID);
+    }
+    prog_ofstream.flush();
+    std::cout << "Snapshot " << snapshot_fpath << ": " << programs.size() << " programs; dominant: " << dom_id
+              << " (min fitness=" << prog_stats[dom_id].GetMin() << ", mean fitness=" << prog_stats[dom_id].GetMean() << ")" << std::endl;
+  }
+  prog_ofstream.close();
+}
+
+/// Mutational landscape of the agent in ANALYZE_AGENT_FPATH: evaluate (TRIAL_CNT trials each) every
+/// single-instruction knockout, every function deletion, and LANDSCAPE_MUTANT_CNT random mutants (see
+/// MutationalLandscape), writing one row per variant. Every variant is evaluated on the same trials
+/// as the parent (same seeds), so fitness differences come from the mutation, not from trial sampling.
+void Experiment::Analysis_Landscape() {
+  program_t parent(inst_lib);
+  if (!program_loader->LoadFile(ANALYZE_AGENT_FPATH, parent)) {
+    std::cout << "Failed to load analysis program file (" << program_loader->GetError() << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  std::cout << " --- Analysis program: ---" << std::endl;
+  parent.PrintProgramFull();
+
+  landscape_t landscape(parent);
+  landscape.AddKnockouts(inst_lib->GetID("Nop"));
+  landscape.AddFunctionDeletions();
+  emp::Random mut_random(random->GetInt(1, 2000000000));
+  landscape.AddMutants(LANDSCAPE_MUTANT_CNT, [this, &mut_random](program_t & program) {
+    Agent mutant(std::move(program));
+    const size_t mut_cnt = this->Mutate(mutant, mut_random);
+    program = std::move(mutant.GetGenome());
+    return mut_cnt;
+  });
+  if (landscape.GetFailedMutantCnt()) {
+    std::cout << "Warning: failed to draw " << landscape.GetFailedMutantCnt() << " mutants (mutation rates too low?)" << std::endl;
+  }
+  std::cout << "Landscape: " << landscape.GetVariantCnt() << " variants (" << landscape.GetEvalCnt() << " distinct programs)" << std::endl;
+
+  const size_t eval_cnt = landscape.GetEvalCnt();
+  emp::vector<AnalysisStats> eval_stats(eval_cnt);
+  if (analysis_workers.empty()) {
+    const int trial_seed = random->GetInt(1, 2000000000);
+    shared_program_ptr_t local_parent = std::make_shared<const shared_program_t>(parent, inst_dispatch);
+    for (size_t evalID = 0; evalID < eval_cnt; ++evalID) {
+      Agent our_hero(landscape.GetProgram(evalID));
+      our_hero.SetID(0);
+      our_hero.shared_program = GetLandscapeProgram(landscape, evalID, local_parent);
+      agent_phen_cache[our_hero.GetID()].Reset();
+      eval_hw->SetProgram(our_hero.GetSharedProgram(inst_dispatch));
+      random->ResetSeed(trial_seed);
+      this->Evaluate(our_hero);
+      for (size_t tID = 0; tID < TRIAL_CNT; ++tID) eval_stats[evalID].AddTrial(agent_phen_cache[our_hero.GetID()], tID);
+    }
+  } else {
+    // Evaluate programs in parallel.
+    emp::vector<int> trial_seeds(TRIAL_CNT);
+    for (int & seed : trial_seeds) seed = random->GetInt(1, 2000000000);
+    std::atomic<size_t> next_eval(0);
+    analysis_pool->Run(analysis_workers.size(), [this, &landscape, &eval_stats, &trial_seeds, &next_eval, eval_cnt](size_t w) {
+      Experiment & worker = *analysis_workers[w];
+      shared_program_ptr_t local_parent = std::make_shared<const shared_program_t>(worker.LocalizeProgram(landscape.GetParent()), worker.inst_dispatch);
+      for (size_t evalID = next_eval++; evalID < eval_cnt; evalID = next_eval++) {
+        Agent our_hero(landscape.GetProgram(evalID));
+        our_hero.SetID(0);
+        our_hero.shared_program = worker.GetLandscapeProgram(landscape, evalID, local_parent);
+        worker.eval_hw->SetProgram(our_hero.GetSharedProgram(worker.inst_dispatch));
+        for (size_t tID = 0; tID < TRIAL_CNT; ++tID) {
+          worker.EvaluateAnalysisTrial(our_hero, trial_seeds[tID]);
+          eval_stats[evalID].AddTrial(worker.agent_phen_cache[our_hero.GetID()], 0);
+        }
+      }
+    });
+  }
+
+  emp::vector<double> eval_mean(eval_cnt), eval_min(eval_cnt);
+  for (size_t evalID = 0; evalID < eval_cnt; ++evalID) {
+    eval_mean[evalID] = eval_stats[evalID].GetMean();
+    eval_min[evalID] = eval_stats[evalID].GetMin();
+  }
+  std::ofstream prog_ofstream("./"+ANALYSIS_OUTPUT_FNAME);
+  landscape.PrintTable(prog_ofstream, eval_mean, eval_min);
+  prog_ofstream.close();
+  std::cout << " --- Landscape summary (parent: mean fitness=" << eval_mean[0] << ", min fitness=" << eval_min[0] << "): ---" << std::endl;
+  landscape.PrintSummary(std::cout, eval_mean);
+}
+
 void Experiment::Config_Tasks() {
   // Zero out task inputs.
   for (size_t i = 0; i < MAX_TASK_NUM_INPUTS; ++i) task_inputs[i] = 0;
@@ -1082,8 +1774,8 @@ void Experiment::Config_HW() {
     // Add 1 set state instruction for every possible environment state.
     for (size_t i = 0; i < ENVIRONMENT_STATES; ++i) {
       inst_lib->AddInst("SetState-" + emp::to_string(i),
-        [i](hardware_t & hw, const inst_t & inst) {
-          hw.SetTrait(TRAIT_ID__STATE, i);
+        [this, i](hardware_t & hw, const inst_t & inst) {
+          Inst_SetState(*this, i, hw, inst);
         }, 0, "Set internal state to " + emp::to_string(i));
     }
 
@@ -1116,13 +1808,36 @@ void Experiment::Config_HW() {
     }
 
     // Configure evaluation hardware.
-    eval_hw = emp::NewPtr<hardware_t>(inst_lib, event_lib, random);
+    eval_hw = emp::NewPtr<fast_hardware_t>(inst_lib, event_lib, random);
     eval_hw->SetMinBindThresh(SGP_HW_MIN_BIND_THRESH);
     eval_hw->SetMaxCores(SGP_HW_MAX_CORES);
     eval_hw->SetMaxCallDepth(SGP_HW_MAX_CALL_DEPTH);
+    Config_Dispatch();
+    program_loader = emp::NewPtr<program_loader_t>(inst_lib);
 
 }
 
+/// Configure fast instruction dispatch (if SGP_HW_FAST_DISPATCH). Must be called after all
+/// instructions have been added to the instruction library.
+void Experiment::Config_Dispatch() {
+  if (!SGP_HW_FAST_DISPATCH) return;
+  inst_dispatch = emp::NewPtr<dispatch_table_t>();
+  inst_dispatch->BindDefaults();
+  inst_dispatch->BindFun<Inst_Fork>("Fork");
+  inst_dispatch->BindFun<Inst_Terminate>("Terminate");
+  inst_dispatch->BindFun<Inst_Nand>("Nand");
+  inst_dispatch->BindMember<Experiment, &Experiment::Inst_Load1>("Load-1", *this);
+  inst_dispatch->BindMember<Experiment, &Experiment::Inst_Load2>("Load-2", *this);
+  inst_dispatch->BindMember<Experiment, &Experiment::Inst_Submit>("Submit", *this);
+  for (size_t i = 0; i < ENVIRONMENT_STATES; ++i) {
+    inst_dispatch->BindParam<Experiment, Inst_SetState>("SetState-" + emp::to_string(i), *this, i);
+    if (SGP_ACTIVE_SENSORS) inst_dispatch->BindParam<Experiment, Inst_SenseState>("SenseState-" + emp::to_string(i), *this, i);
+    else inst_dispatch->BindParam<Experiment, Inst_SenseState_Inactive>("SenseState-" + emp::to_string(i), *this, i);
+  }
+  inst_dispatch->Lower(inst_lib);
+  eval_hw->SetDispatchTable(inst_dispatch);
+}
+
 // Events.
 void Experiment::HandleEvent__EnvSignal_ED(hardware_t & hw, const event_t & event) { hw.SpawnCore(event.affinity, hw.GetMinBindThresh(), event.msg); }
 void Experiment::HandleEvent__EnvSignal_IMP(hardware_t & hw, const event_t & event) { return; }
@@ -1149,6 +1864,16 @@ void Experiment::Inst_Terminate(hardware_t & hw, const inst_t & inst) {
   core.resize(0);
 }
 
+void Experiment::Inst_SetState(Experiment & exp, size_t state_id, hardware_t & hw, const inst_t & inst) {
+  hw.SetTrait(TRAIT_ID__STATE, state_id);
+  if (exp.PRECOMPUTE_ENV_SCHEDULE) exp.env_schedule.RecordAgentState(exp.eval_time, state_id);
+}
+
+void Experiment::Inst_SenseState(Experiment & exp, size_t state_id, hardware_t & hw, const inst_t & inst) {
+  state_t & state = hw.GetCurState();
+  state.SetLocal(inst.args[0], exp.env_state == state_id);
+}
+
 void Experiment::Inst_Load1(hardware_t & hw, const inst_t & inst) {
   state_t & state = hw.GetCurState();
   state.SetLocal(inst.args[0], task_inputs[input_load_id]); // Load input.
@@ -1326,6 +2051,7 @@ size_t Experiment::Mutate(Agent & agent, emp::Random & rnd) {
       program[fID] = new_fun;
     }
   }
+  if (mut_cnt) agent.shared_program.reset();
   return mut_cnt;
 }
 
@@ -137,6 +137,13 @@ public:
     }
   }
 
+  /// Set inputs to the ones other's solutions were generated for (copying other's solutions rather than
+  /// generating them; other must have the same tasks). Reset everything.
+  void SetSolutions(const TaskSet & other) {
+    Reset();
+    for (size_t i = 0; i < task_lib.size(); ++i) task_lib[i].solutions = other.task_lib[i].solutions;
+  }
+
   /// Submit possible solution, checking against all tasks.
   /// If submission is indeed a solution, record information about task completion.
   /// Return whether or not submitted solution was a solution.
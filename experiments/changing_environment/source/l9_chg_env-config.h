@@ -11,6 +11,7 @@ EMP_BUILD_CONFIG( L9ChgEnvConfig,
   VALUE(GENERATIONS, size_t, 100, "How many generations should we run evolution?"),
   VALUE(EVAL_TIME, size_t, 256, "Agent evaluation time"),
   VALUE(TRIAL_CNT, size_t, 3, "..."),
+  VALUE(SHARED_TRIAL_ENVS, bool, false, "Build each generation's TRIAL_CNT trial environments (task inputs and environment schedules) once and evaluate every agent in the same ones (common random numbers)? Implies PRECOMPUTE_ENV_SCHEDULE. Only used in run mode."),
   VALUE(TASKS_ON, bool, true, "Run with or without tasks?"),
   VALUE(ANCESTOR_FPATH, std::string, "ancestor.gp", "Ancestor program file"),
   GROUP(ENVIRONMENT_GROUP, "Environment Settings"),
@@ -20,6 +21,7 @@ EMP_BUILD_CONFIG( L9ChgEnvConfig,
   VALUE(ENVIRONMENT_CHANGE_METHOD, size_t, 0, "How does the environment change? \n0: Randomly\n1: Regular intervals?"),
   VALUE(ENVIRONMENT_CHANGE_PROB, double, 0.125, "Probability of environment change (if changing randomly)"),
   VALUE(ENVIRONMENT_CHANGE_INTERVAL, size_t, 32, "Number of timesteps between environment changes"),
+  VALUE(PRECOMPUTE_ENV_SCHEDULE, bool, false, "Generate each trial's environment schedule when the trial begins (time between random changes drawn from the geometric distribution) and count env matches from state intervals when it ends, instead of drawing changes and comparing states every time step? Same distribution of environments, different random number draws."),
   GROUP(SELECTION_GROUP, "Selection Settings"),
   VALUE(TOURNAMENT_SIZE, size_t, 4, "How big are tournaments when using tournament selection or any selection method that uses tournaments?"),
   VALUE(SELECTION_METHOD, size_t, 0, "Which selection method are we using? \n0: Tournament\n1: Lexicase\n2: Eco-EA (resource)\n3: MAP-Elites\n4: Roulette"),
@@ -36,6 +38,8 @@ EMP_BUILD_CONFIG( L9ChgEnvConfig,
   VALUE(SGP_HW_MAX_CORES, size_t, 16, "Max number of hardware cores; i.e., max number of simultaneous threads of execution hardware will support."),
   VALUE(SGP_HW_MAX_CALL_DEPTH, size_t, 128, "Max call depth of hardware unit"),
   VALUE(SGP_HW_MIN_BIND_THRESH, double, 0.0, "Hardware minimum referencing threshold"),
+  VALUE(SGP_HW_FAST_DISPATCH, bool, false, "Execute instructions through a dense table of plain function pointers (instead of the instruction library's std::function table)?"),
+  VALUE(SGP_HW_FAST_RESET, bool, false, "Restore hardware from a snapshot saved after its first reset (a full copy of the snapshot, instead of resetting it and re-running reset actions every time)?"),
   GROUP(SGP_MUTATION_GROUP, "SignalGP Mutation Settings"),
   VALUE(SGP__PROG_MAX_ARG_VAL, int, 16, "Maximum argument value for instructions."),
   VALUE(SGP__PER_BIT__TAG_BFLIP_RATE, double, 0.005, "Per-bit mutation rate of tag bit flips."),
@@ -50,10 +54,23 @@ EMP_BUILD_CONFIG( L9ChgEnvConfig,
   VALUE(FITNESS_INTERVAL, size_t, 100, "Interval to record fitness summary stats."),
   VALUE(POP_SNAPSHOT_INTERVAL, size_t, 10000, "Interval to take a full snapshot of the population."),
   VALUE(DATA_DIRECTORY, std::string, "./", "Location to dump data output."),
+  VALUE(DATA_FILE_FORMAT, size_t, 0, "Format of fitness, systematics, and dominant data files. 0: CSV; 1: binary columnar (.sgpcol; convert to CSV with colconv)."),
+  VALUE(SYSTEMATICS_MODE, size_t, 0, "How to track phylogenies for the systematics file. 0: world systematics manager; 1: compact (systematics file from genome hashes; the world is built without its systematics manager)."),
+  VALUE(MEMORY_REPORT_INTERVAL, size_t, 0, "Interval to record estimated memory use by subsystem (world, systematics, phenotype cache, hardware) and resident set size to memory.csv (0: off)."),
+  VALUE(TELEMETRY_SHM_NAME, std::string, "", "Name of a shared memory page to publish live stats to each generation (update, generations/sec, instructions/sec, best/mean score, dominant phenotype, ...) for monitors to poll (see the telemetry tool); empty: off."),
+  GROUP(ISLAND_GROUP, "Island Model Settings"),
+  VALUE(ISLAND_CNT, size_t, 1, "Number of island processes, each evolving its own population (1: no island model). Run one process per island, each with its own ISLAND_ID and DATA_DIRECTORY."),
+  VALUE(ISLAND_ID, size_t, 0, "This process's island (0 to ISLAND_CNT-1). Island i uses random seed RANDOM_SEED+i and sends migrants to island i+1."),
+  VALUE(ISLAND_SHM_NAME, std::string, "/sgp_islands", "Name of the shared memory segment islands exchange migrants through (same for all islands of a run; unique among concurrent runs)."),
+  VALUE(ISLAND_MIGRATION_INTERVAL, size_t, 100, "Generations between migrations."),
+  VALUE(ISLAND_MIGRANT_CNT, size_t, 5, "Number of randomly chosen agents sent to the next island each migration (each replaces a random agent there)."),
   GROUP(ANALYSIS_GROUP, "Analysis Settings"),
-  VALUE(ANALYSIS, size_t, 0, "..."),
+  VALUE(ANALYSIS, size_t, 0, "Which analysis to run. 0: evaluate the agent in ANALYZE_AGENT_FPATH (one row per trial); 1: evaluate every agent in the population snapshots in ANALYZE_SNAPSHOT_FPATHS (one row per agent); 2: mutational landscape of the agent in ANALYZE_AGENT_FPATH (one row per knockout, function deletion, and random single mutant)."),
   VALUE(ANALYZE_AGENT_FPATH, std::string, "ancestor.gp", "Path to single agent program to analzye."),
-  VALUE(ANALYSIS_OUTPUT_FNAME, std::string, "analysis.csv", "...")
+  VALUE(ANALYZE_SNAPSHOT_FPATHS, std::string, "pop_0.pop", "Comma-separated paths to population snapshot (.pop) files to analyze."),
+  VALUE(ANALYSIS_OUTPUT_FNAME, std::string, "analysis.csv", "..."),
+  VALUE(ANALYSIS_THREADS, size_t, 1, "Number of threads used to evaluate analysis trials (1: serially, with a single random number stream as in the paper; otherwise each trial gets its own random number stream, so results do not depend on thread count; 0 => one per hardware thread)"),
+  VALUE(LANDSCAPE_MUTANT_CNT, size_t, 1000, "Mutational landscape analysis: number of random mutants to evaluate (each mutated once with the SGP mutation rates, as offspring are).")
 )
 
 #endif
@@ -0,0 +1,87 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "TrialArena.h"
+
+/// Heap allocation counter for instrumented builds (make count-allocs, i.e., -DSGP_COUNT_ALLOCS -DSGP_HW_ARENA).
+/// With SGP_COUNT_ALLOCS or SGP_HW_ARENA, global operator new/delete are replaced: new draws from this
+/// thread's current TrialArena if there is one (see TrialArena.h), and otherwise counts the call (with
+/// SGP_COUNT_ALLOCS) and forwards to malloc; delete hands arena blocks back to their arena and frees the rest.
+/// So GetAllocCnt counts malloc calls only. Without either flag, nothing is replaced and GetAllocCnt always
+/// returns 0.
+/// NOTE: Replacement operators must be defined exactly once per program, so only include this from
+///       a single translation unit (all experiments here are built from one .cc file).
+
+#ifdef SGP_COUNT_ALLOCS
+constexpr bool ALLOC_COUNTER_ENABLED = true;
+#else
+constexpr bool ALLOC_COUNTER_ENABLED = false;
+#endif
+
+/// Global allocation count (calls to operator new/new[]).
+inline std::atomic<size_t> & AllocCounter() {
+  static std::atomic<size_t> cnt(0);
+  return cnt;
+}
+
+/// Number of heap allocations (operator new/new[] calls) so far.
+inline size_t GetAllocCnt() { return AllocCounter().load(std::memory_order_relaxed); }
+
+/// Genome copy counter: counts copies of evolving programs (see each experiment's Agent), to check that
+/// reproduction copies each offspring's genome at most once. Counted in debug builds and with
+/// SGP_COUNT_ALLOCS; otherwise CountGenomeCopy does nothing and GetGenomeCopyCnt always returns 0.
+#if !defined(NDEBUG) || defined(SGP_COUNT_ALLOCS)
+constexpr bool GENOME_COPY_COUNTER_ENABLED = true;
+#else
+constexpr bool GENOME_COPY_COUNTER_ENABLED = false;
+#endif
+
+inline std::atomic<size_t> & GenomeCopyCounter() {
+  static std::atomic<size_t> cnt(0);
+  return cnt;
+}
+
+inline void CountGenomeCopy() {
+  if (GENOME_COPY_COUNTER_ENABLED) GenomeCopyCounter().fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Number of genome copies so far.
+inline size_t GetGenomeCopyCnt() { return GenomeCopyCounter().load(std::memory_order_relaxed); }
+
+#if defined(SGP_COUNT_ALLOCS) || defined(SGP_HW_ARENA)
+/// Single allocation/free functions behind the replacement operators (CountedAllocate: nullptr if out of memory).
+inline void * CountedAllocate(size_t size) {
+  if (void * ptr = TrialArena::AllocateCurrent(size)) return ptr;
+  if (ALLOC_COUNTER_ENABLED) AllocCounter().fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+void * operator new(size_t size) {
+  if (void * ptr = CountedAllocate(size)) return ptr;
+  throw std::bad_alloc();
+}
+void * operator new[](size_t size) { return ::operator new(size); }
+void * operator new(size_t size, const std::nothrow_t &) noexcept { return CountedAllocate(size); }
+void * operator new[](size_t size, const std::nothrow_t & tag) noexcept { return ::operator new(size, tag); }
+
+// GCC flags free() on operator new's pointer once these are inlined, though new here is malloc.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+inline void CountedFree(void * ptr) {
+  if (!TrialArena::DeallocateIfOwned(ptr)) std::free(ptr);
+}
+void operator delete(void * ptr) noexcept { CountedFree(ptr); }
+void operator delete[](void * ptr) noexcept { CountedFree(ptr); }
+void operator delete(void * ptr, size_t) noexcept { CountedFree(ptr); }
+void operator delete[](void * ptr, size_t) noexcept { CountedFree(ptr); }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#endif
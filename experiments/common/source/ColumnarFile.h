@@ -0,0 +1,276 @@
+#ifndef COLUMNAR_FILE_H
+#define COLUMNAR_FILE_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include "base/assert.h"
+#include "base/vector.h"
+
+/// Binary columnar data files: an alternative to emp::DataFile (CSV) for data written from the
+/// evolution loop. Every column is a fixed-width (8-byte) integer, unsigned integer, or double; rows
+/// are buffered and written a block at a time, column by column, with each column's min and max.
+///
+/// File layout (native byte order):
+///   "SGPCOL1\n", uint32 column count, then for each column: uint8 type, uint32 name length, name,
+///   uint32 description length, description.
+///   Blocks: uint32 row count, then for each column: min, max, and one value per row (8 bytes each).
+///
+/// A block is written when it is full or, if rows come in slowly, once the oldest buffered row is more than
+/// the flush interval (default 10 seconds; SetFlushInterval) old, so a killed run loses at most that many
+/// seconds (plus one update) of rows. The reader stops at a cut-short block.
+/// Use ColumnarReader (or the colconv tool) to get CSV back.
+namespace columnar {
+  enum ColType : uint8_t { COL_INT = 0, COL_UINT = 1, COL_DOUBLE = 2 };
+
+  union Value {
+    int64_t i;
+    uint64_t u;
+    double d;
+  };
+
+  static constexpr char MAGIC[8] = {'S','G','P','C','O','L','1','\n'};
+
+  template <typename T>
+  constexpr ColType GetColType() {
+    return std::is_floating_point<T>::value ? COL_DOUBLE : (std::is_signed<T>::value ? COL_INT : COL_UINT);
+  }
+
+  template <typename T>
+  Value ToValue(T val) {
+    Value out;
+    switch (GetColType<T>()) {
+      case COL_INT: out.i = (int64_t)val; break;
+      case COL_UINT: out.u = (uint64_t)val; break;
+      default: out.d = (double)val; break;
+    }
+    return out;
+  }
+
+  inline bool Less(ColType type, const Value & a, const Value & b) {
+    switch (type) {
+      case COL_INT: return a.i < b.i;
+      case COL_UINT: return a.u < b.u;
+      default: return a.d < b.d;
+    }
+  }
+
+  inline void Print(std::ostream & os, ColType type, const Value & val) {
+    switch (type) {
+      case COL_INT: os << val.i; break;
+      case COL_UINT: os << val.u; break;
+      default: os << val.d; break;
+    }
+  }
+}
+
+/// Columnar file writer. Like emp::DataFile: add columns with AddFun/AddVar, then call Update every
+/// update (rows are only added on updates that are multiples of SetTimingRepeat), or AddRow directly.
+class ColumnarFile {
+public:
+  using ColType = columnar::ColType;
+  using Value = columnar::Value;
+
+protected:
+  struct Column {
+    ColType type;
+    std::string name;
+    std::string desc;
+    std::function<Value()> get;
+    emp::vector<Value> values;   ///< Current block.
+  };
+
+  std::ofstream os;
+  emp::vector<Column> columns;
+  size_t block_rows;     ///< Rows per block.
+  size_t buffered_rows;  ///< Rows in current block.
+  size_t repeat;         ///< Add a row every repeat updates.
+  bool started;          ///< Has header been written?
+  std::chrono::steady_clock::duration flush_interval;  ///< Max age of a buffered row.
+  std::chrono::steady_clock::time_point block_start;   ///< When first row of current block was added.
+
+  void Write(const void * data, size_t bytes) { os.write(static_cast<const char*>(data), (std::streamsize)bytes); }
+  void WriteString(const std::string & str) {
+    const uint32_t len = (uint32_t)str.size();
+    Write(&len, sizeof(len));
+    Write(str.data(), str.size());
+  }
+
+  bool IsFlushDue() const { return std::chrono::steady_clock::now() - block_start >= flush_interval; }
+
+  void WriteHeader() {
+    Write(columnar::MAGIC, sizeof(columnar::MAGIC));
+    const uint32_t col_cnt = (uint32_t)columns.size();
+    Write(&col_cnt, sizeof(col_cnt));
+    for (const Column & col : columns) {
+      const uint8_t type = col.type;
+      Write(&type, sizeof(type));
+      WriteString(col.name);
+      WriteString(col.desc);
+    }
+    started = true;
+  }
+
+public:
+  ColumnarFile(const std::string & fpath, size_t _block_rows=256)
+    : os(fpath, std::ios::binary), columns(), block_rows(_block_rows ? _block_rows : 1), buffered_rows(0),
+      repeat(1), started(false), flush_interval(std::chrono::seconds(10)), block_start() { ; }
+
+  ~ColumnarFile() { Flush(); }
+
+  ColumnarFile(const ColumnarFile &) = delete;
+  ColumnarFile & operator=(const ColumnarFile &) = delete;
+
+  bool IsGood() const { return os.good(); }
+  size_t GetNumCols() const { return columns.size(); }
+
+  /// Add a column whose values come from fun (called once per row).
+  template <typename T>
+  void AddFun(const std::function<T()> & fun, const std::string & name, const std::string & desc="") {
+    emp_assert(!started, "Columns must be added before any rows.");
+    columns.push_back(Column{columnar::GetColType<T>(), name, desc, [fun]() { return columnar::ToValue<T>(fun()); }, {}});
+    columns.back().values.reserve(block_rows);
+  }
+
+  /// Add a column whose values come from var.
+  template <typename T>
+  void AddVar(const T & var, const std::string & name, const std::string & desc="") {
+    std::function<T()> fun = [&var]() { return var; };
+    AddFun<T>(fun, name, desc);
+  }
+
+  void SetTimingRepeat(size_t step) { repeat = step; }
+
+  /// Write a partial block when a row has been buffered for longer than seconds (0: every row).
+  void SetFlushInterval(double seconds) {
+    flush_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+  }
+
+  /// Add a row if update is a multiple of the timing repeat; otherwise, write the buffered rows if they are due.
+  void Update(size_t update) {
+    if (repeat && update % repeat == 0) AddRow();
+    else if (buffered_rows && IsFlushDue()) Flush();
+  }
+
+  void AddRow() {
+    if (!started) WriteHeader();
+    if (!buffered_rows) block_start = std::chrono::steady_clock::now();
+    for (Column & col : columns) col.values.emplace_back(col.get());
+    if (++buffered_rows >= block_rows || IsFlushDue()) Flush();
+  }
+
+  /// Write out buffered rows (as a block).
+  void Flush() {
+    if (!started) WriteHeader();
+    if (buffered_rows) {
+      const uint32_t row_cnt = (uint32_t)buffered_rows;
+      Write(&row_cnt, sizeof(row_cnt));
+      for (Column & col : columns) {
+        Value min_val = col.values[0], max_val = col.values[0];
+        for (const Value & val : col.values) {
+          if (columnar::Less(col.type, val, min_val)) min_val = val;
+          if (columnar::Less(col.type, max_val, val)) max_val = val;
+        }
+        Write(&min_val, sizeof(Value));
+        Write(&max_val, sizeof(Value));
+        Write(col.values.data(), col.values.size() * sizeof(Value));
+        col.values.clear();
+      }
+      buffered_rows = 0;
+    }
+    os.flush();
+  }
+};
+
+/// Reads columnar files written by ColumnarFile, a block at a time.
+class ColumnarReader {
+public:
+  using ColType = columnar::ColType;
+  using Value = columnar::Value;
+
+  struct Column {
+    ColType type;
+    std::string name;
+    std::string desc;
+    Value min;                   ///< Over current block.
+    Value max;                   ///< Over current block.
+    emp::vector<Value> values;   ///< Current block.
+  };
+
+protected:
+  std::ifstream is;
+  emp::vector<Column> columns;
+  size_t block_rows;
+
+  bool Read(void * data, size_t bytes) {
+    is.read(static_cast<char*>(data), (std::streamsize)bytes);
+    return (size_t)is.gcount() == bytes;
+  }
+  bool ReadString(std::string & str) {
+    uint32_t len = 0;
+    if (!Read(&len, sizeof(len))) return false;
+    str.resize(len);
+    return len == 0 || Read(&str[0], len);
+  }
+
+public:
+  ColumnarReader() : is(), columns(), block_rows(0) { ; }
+
+  /// Open file and read its schema. Returns false if file is missing or not a columnar file.
+  bool Open(const std::string & fpath) {
+    is.open(fpath, std::ios::binary);
+    columns.clear();
+    block_rows = 0;
+    char magic[sizeof(columnar::MAGIC)];
+    if (!is.is_open() || !Read(magic, sizeof(magic)) || std::memcmp(magic, columnar::MAGIC, sizeof(magic)) != 0) return false;
+    uint32_t col_cnt = 0;
+    if (!Read(&col_cnt, sizeof(col_cnt))) return false;
+    columns.resize(col_cnt);
+    for (Column & col : columns) {
+      uint8_t type = 0;
+      if (!Read(&type, sizeof(type)) || type > columnar::COL_DOUBLE) return false;
+      col.type = (ColType)type;
+      if (!ReadString(col.name) || !ReadString(col.desc)) return false;
+    }
+    return true;
+  }
+
+  const emp::vector<Column> & GetColumns() const { return columns; }
+  size_t GetBlockRows() const { return block_rows; }
+
+  /// Load next block. Returns false at the end of the file (or at a cut-short block).
+  bool NextBlock() {
+    uint32_t row_cnt = 0;
+    block_rows = 0;
+    if (!Read(&row_cnt, sizeof(row_cnt))) return false;
+    for (Column & col : columns) {
+      col.values.resize(row_cnt);
+      if (!Read(&col.min, sizeof(Value)) || !Read(&col.max, sizeof(Value))) return false;
+      if (!Read(col.values.data(), row_cnt * sizeof(Value))) return false;
+    }
+    block_rows = row_cnt;
+    return true;
+  }
+
+  void PrintHeader(std::ostream & os) const {
+    for (size_t i = 0; i < columns.size(); ++i) os << (i ? "," : "") << columns[i].name;
+    os << "\n";
+  }
+
+  void PrintBlock(std::ostream & os) const {
+    for (size_t row = 0; row < block_rows; ++row) {
+      for (size_t i = 0; i < columns.size(); ++i) {
+        if (i) os << ",";
+        columnar::Print(os, columns[i].type, columns[i].values[row]);
+      }
+      os << "\n";
+    }
+  }
+};
+
+#endif
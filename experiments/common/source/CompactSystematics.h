@@ -0,0 +1,119 @@
+#ifndef COMPACT_SYSTEMATICS_H
+#define COMPACT_SYSTEMATICS_H
+
+#include <cmath>
+#include <cstdint>
+#include "base/assert.h"
+#include "base/vector.h"
+
+/// Memory-bounded phylogeny tracking: a stand-in for the world's systematics manager on long runs.
+/// - Taxa store a 64-bit genome hash rather than a copy of the genome, and live in one pooled vector
+///   (slots of pruned taxa are reused), so memory is bounded by living taxa and their ancestors.
+/// - As in the world's manager, an offspring joins its parent's taxon if their genomes match and starts
+///   a new taxon otherwise. Taxa with no living organisms and no remaining descendant taxa are pruned
+///   (and so on up the lineage).
+/// - Reports the same summary statistics as the world's systematics file.
+class CompactSystematics {
+public:
+  static constexpr uint32_t NO_TAXON = (uint32_t)-1;
+
+protected:
+  struct Taxon {
+    uint64_t genome_hash;
+    uint32_t parent;
+    uint32_t depth;
+    uint32_t num_orgs;        ///< Living organisms in this taxon (0 for unused slots).
+    uint32_t num_offspring;   ///< Descendant taxa still being tracked.
+  };
+
+  emp::vector<Taxon> taxa;
+  emp::vector<uint32_t> free_ids;
+  size_t num_active;
+  size_t num_roots;
+  size_t total_orgs;
+  size_t total_depth;
+
+  void Prune(uint32_t id) {
+    while (id != NO_TAXON && taxa[id].num_orgs == 0 && taxa[id].num_offspring == 0) {
+      const uint32_t parent = taxa[id].parent;
+      free_ids.emplace_back(id);
+      if (parent == NO_TAXON) --num_roots;
+      else --taxa[parent].num_offspring;
+      id = parent;
+    }
+  }
+
+public:
+  CompactSystematics()
+    : taxa(), free_ids(), num_active(0), num_roots(0), total_orgs(0), total_depth(0) { ; }
+
+  /// Add an organism (with genome_hash) whose parent is in taxon parent (NO_TAXON for injected organisms).
+  /// Returns the organism's taxon.
+  uint32_t AddOrg(uint64_t genome_hash, uint32_t parent=NO_TAXON) {
+    uint32_t id = parent;
+    if (parent == NO_TAXON || taxa[parent].genome_hash != genome_hash) {
+      const Taxon taxon{genome_hash, parent, (parent == NO_TAXON) ? 0 : taxa[parent].depth + 1, 0, 0};
+      if (free_ids.size()) {
+        id = free_ids.back();
+        free_ids.pop_back();
+        taxa[id] = taxon;
+      } else {
+        id = (uint32_t)taxa.size();
+        taxa.emplace_back(taxon);
+      }
+      if (parent == NO_TAXON) ++num_roots;
+      else ++taxa[parent].num_offspring;
+    }
+    if (taxa[id].num_orgs++ == 0) ++num_active;
+    ++total_orgs;
+    total_depth += taxa[id].depth;
+    return id;
+  }
+
+  /// Remove an organism from taxon id.
+  void RemoveOrg(uint32_t id) {
+    emp_assert(id < taxa.size() && taxa[id].num_orgs > 0);
+    --total_orgs;
+    total_depth -= taxa[id].depth;
+    if (--taxa[id].num_orgs == 0) {
+      --num_active;
+      Prune(id);
+    }
+  }
+
+  size_t GetNumActive() const { return num_active; }
+  size_t GetTotalOrgs() const { return total_orgs; }
+  size_t GetNumRoots() const { return num_roots; }
+  double GetAveDepth() const { return (double)total_depth / (double)total_orgs; }
+
+  /// Number of taxa being tracked (living taxa plus their ancestors).
+  size_t GetNumTaxa() const { return taxa.size() - free_ids.size(); }
+  /// Bytes held by the taxon pool.
+  size_t GetMemoryBytes() const { return taxa.capacity() * sizeof(Taxon) + free_ids.capacity() * sizeof(uint32_t); }
+
+  /// Depth of the most recent common ancestor of all living organisms (-1 if there is none).
+  int GetMRCADepth() const {
+    if (num_roots != 1) return -1;
+    uint32_t candidate = NO_TAXON;
+    for (uint32_t id = 0; id < taxa.size() && candidate == NO_TAXON; ++id) if (taxa[id].num_orgs) candidate = id;
+    if (candidate == NO_TAXON) return -1;
+    // Climb to the oldest ancestor that is alive or a branch point.
+    for (uint32_t test = taxa[candidate].parent; test != NO_TAXON; test = taxa[test].parent) {
+      if (taxa[test].num_offspring > 1 || taxa[test].num_orgs > 0) candidate = test;
+    }
+    return (int)taxa[candidate].depth;
+  }
+
+  /// Genotypic diversity (entropy of living taxa).
+  double CalcDiversity() const {
+    double entropy = 0.0;
+    for (const Taxon & taxon : taxa) {
+      if (!taxon.num_orgs) continue;
+      const double p = (double)taxon.num_orgs / (double)total_orgs;
+      entropy -= p * std::log2(p);
+    }
+    return entropy;
+  }
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef COMPACT_SYSTEMATICS_TRACKER_H
+#define COMPACT_SYSTEMATICS_TRACKER_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include "base/Ptr.h"
+#include "base/assert.h"
+#include "base/vector.h"
+#include "data/DataFile.h"
+
+#include "ColumnarFile.h"
+#include "CompactSystematics.h"
+#include "MemoryUsage.h"
+#include "WorldDataFiles.h"
+
+/// Tracks a world's phylogeny with CompactSystematics (rather than the world's systematics manager) and
+/// writes the systematics file from it, in CSV or columnar format (WORLD: emp::World; CODEC: GenomeCodec
+/// over the world's genome type, used to hash genomes).
+/// - Births are hooked on construction (each offspring's parent is remembered); call Track right after
+///   every world update (once offspring are in place), and TrackInjection for every agent placed directly
+///   (initial population, migrants), which starts a new lineage.
+/// - Meant to be the world's only systematics: build the world without its systematics manager (remove it
+///   before any agent is placed), or it keeps a genome copy per taxon alongside this tracker.
+template <typename WORLD, typename CODEC>
+class CompactSystematicsTracker {
+public:
+  using world_t = WORLD;
+  using codec_t = CODEC;
+
+protected:
+  emp::Ptr<world_t> world;
+  CompactSystematics sys;
+  emp::Ptr<emp::DataFile> file;
+  emp::Ptr<ColumnarFile> columnar_file;
+  size_t interval;
+  emp::vector<uint32_t> org_taxa;        ///< Taxon of each agent in the population.
+  emp::vector<uint32_t> next_org_taxa;
+  emp::vector<size_t> birth_parents;     ///< Parent position of each birth since the last world update.
+  size_t birth_parent;
+  typename codec_t::buffer_t genome_scratch;
+
+public:
+  /// Track world's systematics, writing them to fpath (a columnar file if columnar; CSV otherwise) every
+  /// interval updates.
+  CompactSystematicsTracker(world_t & _world, const std::string & fpath, bool columnar, size_t _interval)
+    : world(&_world), sys(), file(nullptr), columnar_file(nullptr), interval(_interval), org_taxa(), next_org_taxa(),
+      birth_parents(), birth_parent(0), genome_scratch()
+  {
+    // Remember each birth's parent; offspring are hashed once the world update puts them in place.
+    world->OnBeforeRepro([this](size_t parent_pos) { birth_parent = parent_pos; });
+    world->OnOffspringReady([this](auto &) { birth_parents.emplace_back(birth_parent); });
+    // Rows are recorded right after the world update (see Track).
+    std::function<size_t(void)> get_update = [this]() { return world->GetUpdate() - 1; };
+    if (columnar) {
+      columnar_file = emp::NewPtr<ColumnarFile>(fpath);
+      columnar_file->AddFun(get_update, "update", "Update");
+      AddSystematicsColumns(*columnar_file, sys).SetTimingRepeat(interval);
+    } else {
+      file = emp::NewPtr<emp::DataFile>(fpath);
+      file->AddFun(get_update, "update", "Update");
+      AddSystematicsColumns(*file, sys).SetTimingRepeat(interval);
+      file->PrintHeaderKeys();
+    }
+  }
+
+  ~CompactSystematicsTracker() {
+    if (file) file.Delete();
+    if (columnar_file) columnar_file.Delete();
+  }
+
+  CompactSystematicsTracker(const CompactSystematicsTracker &) = delete;
+  CompactSystematicsTracker & operator=(const CompactSystematicsTracker &) = delete;
+
+  const CompactSystematics & GetSystematics() const { return sys; }
+
+  /// Bytes held by the taxon pool and per-agent taxa.
+  size_t GetMemoryBytes() const {
+    return sys.GetMemoryBytes() + memory_usage::VectorBytes(org_taxa) + memory_usage::VectorBytes(next_org_taxa);
+  }
+
+  /// Add the offspring that the world update just put in place (and remove the previous generation).
+  /// Every interval updates, also print how many taxa are tracked to os.
+  void Track(std::ostream & os=std::cout) {
+    emp_assert(birth_parents.size() == world->GetSize());
+    next_org_taxa.resize(world->GetSize());
+    for (size_t pos = 0; pos < world->GetSize(); ++pos) {
+      const uint64_t genome_hash = codec_t::Hash(world->GetOrg(pos).GetGenome(), genome_scratch);
+      next_org_taxa[pos] = sys.AddOrg(genome_hash, org_taxa[birth_parents[pos]]);
+    }
+    // Like the world's systematics file, rows count both generations.
+    const size_t prev_update = world->GetUpdate() - 1;
+    if (file) file->Update(prev_update);
+    if (columnar_file) columnar_file->Update(prev_update);
+    if (prev_update % interval == 0) {
+      os << "Systematics: " << sys.GetNumTaxa() << " taxa tracked (" << sys.GetMemoryBytes() << " bytes)" << std::endl;
+    }
+    for (uint32_t taxon : org_taxa) sys.RemoveOrg(taxon);
+    std::swap(org_taxa, next_org_taxa);
+    birth_parents.clear();
+  }
+
+  /// Start a new lineage for the agent placed at pos.
+  void TrackInjection(size_t pos) {
+    if (org_taxa.size() <= pos) org_taxa.resize(pos + 1, (uint32_t)CompactSystematics::NO_TAXON);
+    if (org_taxa[pos] != CompactSystematics::NO_TAXON) sys.RemoveOrg(org_taxa[pos]);
+    org_taxa[pos] = sys.AddOrg(codec_t::Hash(world->GetOrg(pos).GetGenome(), genome_scratch));
+  }
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef DECODED_PROGRAM_H
+#define DECODED_PROGRAM_H
+
+#include <iostream>
+#include "base/vector.h"
+
+#include "InstDispatchTable.h"
+#include "MemoryUsage.h"
+
+/// SignalGP program compiled for the fast core (see FastEventDrivenGP.h): one flat array of decoded
+/// instructions (all functions back-to-back), each carrying its dispatch entry and a copy of its arguments.
+/// - Block-defining instructions (block_def) have their matching block_close resolved up front, so
+///   If/While/Countdown never scan forward for the end of their block.
+/// - Nops are marked so the core can skip them without a call. They still cost a cycle each; collapsing a
+///   run into fewer cycles would change program timing (and therefore results).
+/// - Instruction IDs are checked against the dispatch table once here, so the core does not check them.
+///   Arguments are copied as is, not range-checked: any int is a valid memory position (memories are maps),
+///   so there is nothing to check ahead of time.
+/// A decoded program is only valid for the program and dispatch table it was decoded from. Re-decode
+/// (or Clear) after the program is mutated. Programs are only decoded for hardware with a dispatch table
+/// (SGP_HW_FAST_DISPATCH); otherwise they run as is.
+template <typename HARDWARE>
+class DecodedProgram {
+public:
+  using hardware_t = HARDWARE;
+  using inst_t = typename hardware_t::inst_t;
+  using program_t = typename hardware_t::program_t;
+  using dispatch_table_t = InstDispatchTable<hardware_t>;
+  using entry_t = typename dispatch_table_t::Entry;
+
+  struct DecodedInst {
+    entry_t entry;      ///< Copy of dispatch table entry.
+    size_t block_end;   ///< block_def instructions: position of matching block_close (or function size).
+    size_t block_exit;  ///< block_def instructions: where to go when skipping the block.
+    inst_t inst;
+  };
+
+protected:
+  emp::vector<DecodedInst> insts;    ///< All functions, concatenated.
+  emp::vector<size_t> fun_offsets;   ///< Function fp occupies [fun_offsets[fp]:fun_offsets[fp+1]).
+  emp::vector<size_t> open_blocks;   ///< Scratch space for Decode.
+  bool valid;
+
+public:
+  DecodedProgram() : insts(), fun_offsets(1, 0), open_blocks(), valid(false) { ; }
+
+  bool IsValid() const { return valid; }
+  size_t GetFunctionCnt() const { return fun_offsets.size() - 1; }
+  size_t GetFunctionSize(size_t fp) const { return fun_offsets[fp+1] - fun_offsets[fp]; }
+  size_t GetInstCnt() const { return insts.size(); }
+  const DecodedInst * GetFunction(size_t fp) const { return insts.data() + fun_offsets[fp]; }
+  size_t GetMemoryBytes() const {
+    return memory_usage::VectorBytes(insts) + memory_usage::VectorBytes(fun_offsets) + memory_usage::VectorBytes(open_blocks);
+  }
+
+  void Clear() {
+    insts.clear();
+    fun_offsets.resize(1);
+    valid = false;
+  }
+
+  bool Decode(const program_t & program, const dispatch_table_t & table, std::ostream & err=std::cerr);
+  bool Patch(const program_t & program, size_t fp, size_t ip, const dispatch_table_t & table);
+};
+
+/// Decode program against (lowered) dispatch table. Returns false (after reporting the offending
+/// function and position) if the program contains an instruction the table does not know about.
+template <typename HARDWARE>
+bool DecodedProgram<HARDWARE>::Decode(const program_t & program, const dispatch_table_t & table, std::ostream & err) {
+  Clear();
+  const auto & inst_lib = *program.GetInstLib();
+  insts.reserve(program.GetInstCnt());
+  for (size_t fp = 0; fp < program.GetSize(); ++fp) {
+    const size_t begin = insts.size();
+    const size_t fun_size = program[fp].GetSize();
+    open_blocks.clear();
+    for (size_t ip = 0; ip < fun_size; ++ip) {
+      const inst_t & inst = program[fp].inst_seq[ip];
+      if (inst.id >= table.GetSize()) {
+        err << "Decode: unknown instruction ID " << inst.id << " (function " << fp << ", position " << ip << ")" << std::endl;
+        Clear();
+        return false;
+      }
+      insts.emplace_back(DecodedInst{table.GetEntry(inst.id), fun_size, fun_size, inst});
+      // Match blocks (equivalent to hardware_t::FindEndOfBlock).
+      if (inst_lib.HasProperty(inst.id, "block_def")) {
+        open_blocks.emplace_back(ip);
+      } else if (inst_lib.HasProperty(inst.id, "block_close") && open_blocks.size()) {
+        DecodedInst & def = insts[begin + open_blocks.back()];
+        def.block_end = ip;
+        def.block_exit = ip + 1;
+        open_blocks.pop_back();
+      }
+    }
+    fun_offsets.emplace_back(insts.size());
+  }
+  valid = true;
+  return true;
+}
+
+/// Re-decode just instruction ip of function fp after it changed (e.g., was knocked out), rather than the
+/// whole program. Only possible if neither the old nor the new instruction defines or closes a block
+/// (otherwise block ends move); returns false (leaving this decoded program unchanged) if not possible.
+template <typename HARDWARE>
+bool DecodedProgram<HARDWARE>::Patch(const program_t & program, size_t fp, size_t ip, const dispatch_table_t & table) {
+  if (!valid || fp >= GetFunctionCnt() || ip >= GetFunctionSize(fp)) return false;
+  const auto & inst_lib = *program.GetInstLib();
+  const inst_t & inst = program[fp].inst_seq[ip];
+  DecodedInst & decoded = insts[fun_offsets[fp] + ip];
+  if (inst.id >= table.GetSize()) return false;
+  for (size_t id : {decoded.inst.id, inst.id}) {
+    if (inst_lib.HasProperty(id, "block_def") || inst_lib.HasProperty(id, "block_close")) return false;
+  }
+  decoded.entry = table.GetEntry(inst.id);
+  decoded.inst = inst;
+  return true;
+}
+
+#endif
@@ -0,0 +1,390 @@
+#ifndef FAST_EVENT_DRIVEN_GP_H
+#define FAST_EVENT_DRIVEN_GP_H
+
+#include <deque>
+#include <memory>
+#include "base/Ptr.h"
+#include "base/assert.h"
+#include "base/vector.h"
+#include "hardware/EventDrivenGP.h"
+
+#include "InstDispatchTable.h"
+#include "DecodedProgram.h"
+#include "SharedProgram.h"
+#include "MemoryUsage.h"
+#include "TrialArena.h"
+
+/// EventDrivenGP_AW with an alternative execution core.
+/// - Without a dispatch table, this is exactly EventDrivenGP_AW.
+/// - With a dispatch table (SetDispatchTable), programs are decoded (see DecodedProgram.h) when set, and
+///   SingleProcess executes the decoded program: instructions go through the table's dense array of plain
+///   function pointers rather than the instruction library's std::function table, Nops are skipped without a
+///   call, and If/While/Countdown use pre-resolved block ends. Everything else (event handling, core
+///   scheduling, block closing/function returns when falling off the end of a function) follows
+///   EventDrivenGP_AW::SingleProcess.
+/// - SaveResetState/RestoreResetState snapshot and restore the hardware's run-time state (cores, memory,
+///   event queue, traits). Saving right after a reset (and any post-reset setup, like spawning a main core)
+///   gives a pristine template that can be restored by copy instead of redoing the reset. Restoring is a full
+///   copy of the saved state by design: a post-reset state is small (typically one main core with empty
+///   memory), and instructions write memory through the base type, so tracking dirty cores would mean
+///   hooking every write for little gain. Fast reset saves re-running reset actions, not copying.
+/// - In SGP_HW_ARENA builds, run-time state is drawn from a per-hardware TrialArena (see TrialArena.h), made at
+///   the first ResetHardware/RestoreResetState with room for max cores x max call depth call states. Each reset
+///   releases the old state and resets the arena in one step before building the new state. SingleProcess,
+///   SpawnCore, TriggerEvent, and QueueEvent allocate from the arena; other callers can use ArenaScope.
+/// - A program can be given as a SharedProgram (see SharedProgram.h), which is referenced rather than copied.
+///   If the shared program was decoded against this hardware's dispatch table, the hardware keeps only a
+///   copy of the program's skeleton (function tags) for the base class's function lookups.
+/// NOTE: SetProgram/GetProgram/Reset/ResetHardware/SingleProcess/Process and the arena-scoped calls hide
+///       (rather than override) the base versions; call them through this type. Inside instructions and event
+///       handlers (which see the base type), the program may be a skeleton.
+template <size_t AFFINITY_WIDTH>
+class FastEventDrivenGP_AW : public emp::EventDrivenGP_AW<AFFINITY_WIDTH> {
+public:
+  using base_t = emp::EventDrivenGP_AW<AFFINITY_WIDTH>;
+  using inst_t = typename base_t::inst_t;
+  using inst_lib_t = typename base_t::inst_lib_t;
+  using event_lib_t = typename base_t::event_lib_t;
+  using exec_stk_t = typename base_t::exec_stk_t;
+  using state_t = typename base_t::State;
+  using function_t = typename base_t::Function;
+  using program_t = typename base_t::Program;
+  using block_t = typename base_t::BlockType;
+  using dispatch_table_t = InstDispatchTable<base_t>;
+  using decoded_program_t = DecodedProgram<base_t>;
+  using decoded_inst_t = typename decoded_program_t::DecodedInst;
+  using memory_t = typename base_t::memory_t;
+  using event_t = typename base_t::event_t;
+  using affinity_t = typename base_t::affinity_t;
+  using properties_t = typename base_t::properties_t;
+  using shared_program_t = SharedProgram<base_t>;
+  using shared_program_ptr_t = std::shared_ptr<const shared_program_t>;
+
+  /// Run-time state of hardware (everything ResetHardware resets, plus traits).
+  struct Snapshot {
+    memory_t shared_mem;
+    std::deque<event_t> event_queue;
+    emp::vector<double> traits;
+    emp::vector<exec_stk_t> cores;
+    emp::vector<size_t> active_cores;
+    emp::vector<size_t> inactive_cores;
+    std::deque<size_t> pending_cores;
+    size_t errors;
+    size_t exec_core_id;
+  };
+
+protected:
+  using base_t::program;
+  using base_t::event_queue;
+  using base_t::cores;
+  using base_t::active_cores;
+  using base_t::inactive_cores;
+  using base_t::pending_cores;
+  using base_t::exec_core_id;
+  using base_t::is_executing;
+  using base_t::shared_mem;
+  using base_t::errors;
+  using base_t::traits;
+
+  emp::Ptr<const dispatch_table_t> dispatch_table;
+  decoded_program_t decoded;            ///< Used unless shared_program is decoded for dispatch_table.
+  shared_program_ptr_t shared_program;  ///< Set if program was given as a SharedProgram.
+  Snapshot reset_state;
+  bool has_reset_state;
+  size_t core_step_cnt;                 ///< Core time steps run (~instructions executed); never reset.
+  TrialArena * arena;                   ///< Run-time state allocations (SGP_HW_ARENA builds only; see TrialArena.h).
+
+  bool UsingSharedDecoded() const { return shared_program && shared_program->IsDecodedFor(dispatch_table); }
+  const decoded_program_t & GetDecoded() const { return UsingSharedDecoded() ? shared_program->GetDecoded() : decoded; }
+
+  /// (Re)load program-derived state after the program or the dispatch table changes.
+  void LoadProgram() {
+    decoded.Clear();
+    if (shared_program) {
+      if (UsingSharedDecoded()) { program = shared_program->GetSkeleton(); return; }
+      program = shared_program->GetProgram();
+    }
+    if (dispatch_table) decoded.Decode(program, *dispatch_table);
+  }
+
+  /// Before a reset: make the arena if there is none yet; release run-time state and reset the arena.
+  void PrepareArena() {
+    if (!TRIAL_ARENA_ENABLED) return;
+    if (!arena) arena = TrialArena::Make(base_t::GetMaxCores() * base_t::GetMaxCallDepth() * TrialArena::CALL_STATE_BYTES);
+    if (!arena) return;
+    ReleaseRunState();
+    arena->Reset();
+  }
+
+  /// Give up the arena (max cores or call depth changed); the next reset makes a new one.
+  void DropArena() {
+    if (arena) arena->Release();
+    arena = nullptr;
+  }
+
+public:
+  FastEventDrivenGP_AW(emp::Ptr<const inst_lib_t> _ilib, emp::Ptr<const event_lib_t> _elib,
+                       emp::Ptr<emp::Random> rnd=nullptr)
+    : base_t(_ilib, _elib, rnd), dispatch_table(nullptr), decoded(), shared_program(),
+      reset_state(), has_reset_state(false), core_step_cnt(0), arena(nullptr) { ; }
+
+  FastEventDrivenGP_AW(FastEventDrivenGP_AW && in)
+    : base_t(std::move(in)), dispatch_table(in.dispatch_table), decoded(std::move(in.decoded)),
+      shared_program(std::move(in.shared_program)), reset_state(std::move(in.reset_state)),
+      has_reset_state(in.has_reset_state), core_step_cnt(in.core_step_cnt), arena(in.arena) { in.arena = nullptr; }
+  /// (Copies do not share the arena; they make their own at their first reset.)
+  FastEventDrivenGP_AW(const FastEventDrivenGP_AW & in)
+    : base_t(in), dispatch_table(in.dispatch_table), decoded(in.decoded), shared_program(in.shared_program),
+      reset_state(in.reset_state), has_reset_state(in.has_reset_state), core_step_cnt(in.core_step_cnt), arena(nullptr) { ; }
+  FastEventDrivenGP_AW & operator=(const FastEventDrivenGP_AW &) = delete;
+  FastEventDrivenGP_AW & operator=(FastEventDrivenGP_AW &&) = delete;
+  ~FastEventDrivenGP_AW() { DropArena(); }
+
+  emp::Ptr<const dispatch_table_t> GetDispatchTable() const { return dispatch_table; }
+  bool HasResetState() const { return has_reset_state; }
+  /// Number of core time steps run so far (each executes one instruction or closes a block/returns), for
+  /// instruction throughput.
+  size_t GetCoreStepCnt() const { return core_step_cnt; }
+  /// Arena run-time state is drawn from (nullptr without SGP_HW_ARENA or before the first reset).
+  const TrialArena * GetArena() const { return arena; }
+  /// Make this hardware's arena current on this thread (e.g., around reset actions that spawn cores through
+  /// the base type).
+  TrialArena::Scope ArenaScope() { return TrialArena::Scope(arena); }
+
+  /// Heap bytes held by this hardware (program, call stacks, memory, events, reset snapshot; not counting
+  /// a shared program, which its owner accounts for).
+  size_t GetMemoryBytes() const {
+    using namespace memory_usage;
+    size_t bytes = ProgramBytes(program) + decoded.GetMemoryBytes() + HashBytes(shared_mem) + EventQueueBytes(event_queue)
+                   + VectorBytes(traits) + CoresBytes(cores) + VectorBytes(active_cores) + VectorBytes(inactive_cores)
+                   + DequeBytes(pending_cores);
+    if (has_reset_state) {
+      bytes += HashBytes(reset_state.shared_mem) + EventQueueBytes(reset_state.event_queue) + VectorBytes(reset_state.traits)
+               + CoresBytes(reset_state.cores) + VectorBytes(reset_state.active_cores)
+               + VectorBytes(reset_state.inactive_cores) + DequeBytes(reset_state.pending_cores);
+    }
+    return bytes;
+  }
+
+  /// Use given dispatch table (lowered against this hardware's instruction library) to execute
+  /// instructions. Pass nullptr to go back to the instruction library.
+  void SetDispatchTable(emp::Ptr<const dispatch_table_t> _table) {
+    emp_assert(!_table || _table->GetSize() == base_t::GetInstLib()->GetSize(), "Dispatch table not lowered against this inst lib.");
+    dispatch_table = _table;
+    LoadProgram();
+  }
+
+  void Reset() {
+    base_t::Reset();
+    shared_program.reset();
+    LoadProgram();
+  }
+
+  void SetMaxCores(size_t n) {
+    base_t::SetMaxCores(n);
+    ClearResetState();
+    DropArena();
+  }
+
+  void SetMaxCallDepth(size_t depth) {
+    base_t::SetMaxCallDepth(depth);
+    DropArena();
+  }
+
+  void ResetHardware() {
+    PrepareArena();
+    TrialArena::Scope scope(arena);
+    base_t::ResetHardware();
+  }
+
+  /// Empty run-time state (memory, event queue, call stacks, core lists), returning its storage to the
+  /// arena. Traits persist across resets, so they are moved out of the arena.
+  void ReleaseRunState() {
+    emp_assert(!is_executing);
+    memory_t().swap(shared_mem);
+    event_queue.clear();
+    pending_cores.clear();
+    for (exec_stk_t & core : cores) exec_stk_t().swap(core);
+    emp::vector<size_t>().swap(active_cores);
+    emp::vector<size_t>().swap(inactive_cores);
+    if (arena && traits.size() && arena->OwnsSmall(traits.data())) {
+      TrialArena::Pause pause;
+      emp::vector<double>(traits).swap(traits);
+    }
+  }
+
+  void SpawnCore(const affinity_t & affinity, double threshold, const memory_t & input_mem=memory_t(), bool is_main=false) {
+    TrialArena::Scope scope(arena);
+    base_t::SpawnCore(affinity, threshold, input_mem, is_main);
+  }
+
+  void SpawnCore(size_t fID, const memory_t & input_mem=memory_t(), bool is_main=false) {
+    TrialArena::Scope scope(arena);
+    base_t::SpawnCore(fID, input_mem, is_main);
+  }
+
+  void QueueEvent(const event_t & event) {
+    TrialArena::Scope scope(arena);
+    base_t::QueueEvent(event);
+  }
+
+  void TriggerEvent(const event_t & event) {
+    TrialArena::Scope scope(arena);
+    base_t::TriggerEvent(event);
+  }
+
+  void TriggerEvent(const std::string & name, const affinity_t & affinity=affinity_t(), const memory_t & msg=memory_t(),
+                    const properties_t & properties=properties_t()) {
+    TrialArena::Scope scope(arena);
+    base_t::TriggerEvent(name, affinity, msg, properties);
+  }
+
+  void SaveState(Snapshot & snapshot) const {
+    emp_assert(!is_executing);
+    snapshot.shared_mem = shared_mem;
+    snapshot.event_queue = event_queue;
+    snapshot.traits = traits;
+    snapshot.cores = cores;
+    snapshot.active_cores = active_cores;
+    snapshot.inactive_cores = inactive_cores;
+    snapshot.pending_cores = pending_cores;
+    snapshot.errors = errors;
+    snapshot.exec_core_id = exec_core_id;
+  }
+
+  /// Restore state saved with SaveState (a full copy). Assignment reuses this hardware's existing storage where
+  /// it can (in SGP_HW_ARENA builds, storage is released first and the copy is drawn from the arena).
+  void LoadState(const Snapshot & snapshot) {
+    emp_assert(!is_executing);
+    shared_mem = snapshot.shared_mem;
+    event_queue = snapshot.event_queue;
+    traits = snapshot.traits;
+    cores = snapshot.cores;
+    active_cores = snapshot.active_cores;
+    inactive_cores = snapshot.inactive_cores;
+    pending_cores = snapshot.pending_cores;
+    errors = snapshot.errors;
+    exec_core_id = snapshot.exec_core_id;
+  }
+
+  /// Save current state as this hardware's pristine (post-reset) state.
+  /// (The saved state is kept across trials, so it is never drawn from the arena.)
+  void SaveResetState() {
+    TrialArena::Pause pause;
+    SaveState(reset_state);
+    has_reset_state = true;
+  }
+  void RestoreResetState() {
+    emp_assert(has_reset_state);
+    PrepareArena();
+    TrialArena::Scope scope(arena);
+    LoadState(reset_state);
+  }
+  void ClearResetState() { has_reset_state = false; }
+
+  /// Full program (even if this hardware only holds a skeleton copy).
+  const program_t & GetProgram() const { return shared_program ? shared_program->GetProgram() : program; }
+  shared_program_ptr_t GetSharedProgram() const { return shared_program; }
+
+  void SetProgram(const program_t & _program) {
+    base_t::SetProgram(_program);
+    shared_program.reset();
+    LoadProgram();
+  }
+
+  /// Reference given shared program (rather than copying it).
+  void SetProgram(shared_program_ptr_t _program) {
+    emp_assert(_program);
+    shared_program = _program;
+    LoadProgram();
+  }
+
+  void SingleProcess();
+  void Process(size_t num_steps) { for (size_t i = 0; i < num_steps; ++i) SingleProcess(); }
+};
+
+template <size_t AFFINITY_WIDTH>
+void FastEventDrivenGP_AW<AFFINITY_WIDTH>::SingleProcess() {
+  TrialArena::Scope scope(arena);
+  const decoded_program_t & dprog = GetDecoded();
+  if (!dprog.IsValid()) { core_step_cnt += active_cores.size(); base_t::SingleProcess(); return; }
+  emp_assert(program.GetSize()); // Must have a valid program before advancing hardware.
+  emp_assert(dprog.GetFunctionCnt() == program.GetSize(), "Decoded program does not match program.");
+  // Handle events (which may spawn new cores).
+  while (!event_queue.empty()) {
+    base_t::HandleEvent(event_queue.front());
+    event_queue.pop_front();
+  }
+  // Distribute 1 unit of computational time to each core.
+  const size_t core_cnt = active_cores.size();
+  core_step_cnt += core_cnt;
+  size_t active_core_idx = 0;
+  size_t adjust = 0;
+  is_executing = true;
+  while (active_core_idx < core_cnt) {
+    exec_core_id = active_cores[active_core_idx];
+    // Keep active cores contiguous.
+    if (adjust) {
+      active_cores[active_core_idx] = (size_t)-1;
+      active_cores[active_core_idx - adjust] = exec_core_id;
+    }
+    state_t & state = cores[exec_core_id].back();
+    const size_t ip = state.inst_ptr;
+    const size_t fp = state.func_ptr;
+    const size_t fun_size = dprog.GetFunctionSize(fp);
+    if (ip >= fun_size) {
+      // Hanging off end of function: close current block if there is one; otherwise, return.
+      if (state.block_stack.size()) base_t::CloseBlock();
+      else base_t::ReturnFunction();
+    } else {
+      ++state.inst_ptr;   // NOTE: state may be invalidated by instruction (e.g., Call).
+      const decoded_inst_t & dinst = dprog.GetFunction(fp)[ip];
+      switch (dinst.entry.op) {
+        case INST_OP__NOP:
+          break;
+        case INST_OP__IF:
+          if (state.AccessLocal(dinst.inst.args[0]) == 0.0) state.inst_ptr = dinst.block_exit;
+          else state.block_stack.emplace_back(ip, dinst.block_end, block_t::BASIC);
+          break;
+        case INST_OP__WHILE:
+          if (state.AccessLocal(dinst.inst.args[0]) == 0.0) state.inst_ptr = dinst.block_exit;
+          else state.block_stack.emplace_back(ip, dinst.block_end, block_t::LOOP);
+          break;
+        case INST_OP__COUNTDOWN:
+          if (state.AccessLocal(dinst.inst.args[0]) == 0.0) {
+            state.inst_ptr = dinst.block_exit;
+          } else {
+            --state.AccessLocal(dinst.inst.args[0]);
+            state.block_stack.emplace_back(ip, dinst.block_end, block_t::LOOP);
+          }
+          break;
+        case INST_OP__BREAK:
+          if (state.block_stack.size()) {
+            state.inst_ptr = state.block_stack.back().end;
+            if (state.inst_ptr < fun_size) ++state.inst_ptr;
+            state.block_stack.pop_back();
+          }
+          break;
+        default:
+          dinst.entry.fun(dinst.entry.ctx, dinst.entry.param, *this, dinst.inst);
+      }
+    }
+    // Is the core still active?
+    if (cores[exec_core_id].empty()) {
+      active_cores[active_core_idx - adjust] = (size_t)-1;
+      inactive_cores.emplace_back(exec_core_id);
+      ++adjust;
+    }
+    ++active_core_idx;
+  }
+  active_cores.resize(core_cnt - adjust);
+  if (active_cores.size()) exec_core_id = active_cores[0];
+  // Spawn any cores that were requested during execution.
+  while (pending_cores.size()) {
+    active_cores.emplace_back(pending_cores.front());
+    pending_cores.pop_front();
+  }
+  is_executing = false;
+}
+
+#endif
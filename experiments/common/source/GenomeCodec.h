@@ -0,0 +1,130 @@
+#ifndef GENOME_CODEC_H
+#define GENOME_CODEC_H
+
+#include <cstdint>
+#include "base/vector.h"
+
+/// Compact binary encoding of SignalGP programs (e.g., for shipping migrants between processes; see
+/// IslandRing.h). Counts, instruction IDs, and arguments are (zig-zag) varints; tags are packed bits.
+/// A program is: function count, then for each function its tag, instruction count, and instructions
+/// (ID, three arguments, tag).
+template <typename HARDWARE>
+class GenomeCodec {
+public:
+  using hardware_t = HARDWARE;
+  using program_t = typename hardware_t::program_t;
+  using function_t = typename hardware_t::Function;
+  using inst_t = typename hardware_t::inst_t;
+  using affinity_t = typename hardware_t::affinity_t;
+  using buffer_t = emp::vector<uint8_t>;
+
+  static constexpr size_t TAG_BYTES = (affinity_t::GetSize() + 7) / 8;
+  static constexpr size_t MAX_VARINT_BYTES = 10;
+
+  /// Upper bound on the encoded size of a program with at most max_funcs functions and max_insts instructions.
+  static constexpr size_t GetMaxBytes(size_t max_funcs, size_t max_insts) {
+    return MAX_VARINT_BYTES + max_funcs * (TAG_BYTES + MAX_VARINT_BYTES) + max_insts * (4 * MAX_VARINT_BYTES + TAG_BYTES);
+  }
+
+  static void PutVarint(buffer_t & out, uint64_t val) {
+    while (val >= 0x80) { out.emplace_back((uint8_t)(val | 0x80)); val >>= 7; }
+    out.emplace_back((uint8_t)val);
+  }
+
+  static void PutSigned(buffer_t & out, int64_t val) {
+    PutVarint(out, ((uint64_t)val << 1) ^ (uint64_t)(val >> 63));
+  }
+
+  static void PutTag(buffer_t & out, const affinity_t & tag) {
+    for (size_t byte = 0; byte < TAG_BYTES; ++byte) {
+      uint8_t bits = 0;
+      for (size_t i = 0; i < 8 && byte * 8 + i < affinity_t::GetSize(); ++i) bits |= (uint8_t)tag.Get(byte * 8 + i) << i;
+      out.emplace_back(bits);
+    }
+  }
+
+  /// Reads from an encoded buffer; every Get fails (returns false) once the buffer runs out.
+  class Reader {
+  protected:
+    const uint8_t * pos;
+    const uint8_t * end;
+
+  public:
+    Reader(const uint8_t * _begin, const uint8_t * _end) : pos(_begin), end(_end) { ; }
+
+    bool AtEnd() const { return pos == end; }
+
+    bool GetVarint(uint64_t & val) {
+      val = 0;
+      for (size_t shift = 0; shift < 64; shift += 7) {
+        if (pos == end) return false;
+        const uint8_t byte = *pos++;
+        val |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+      }
+      return false;
+    }
+
+    bool GetSigned(int64_t & val) {
+      uint64_t raw;
+      if (!GetVarint(raw)) return false;
+      val = (int64_t)(raw >> 1) ^ -(int64_t)(raw & 1);
+      return true;
+    }
+
+    bool GetTag(affinity_t & tag) {
+      if ((size_t)(end - pos) < TAG_BYTES) return false;
+      for (size_t i = 0; i < affinity_t::GetSize(); ++i) tag.Set(i, (pos[i / 8] >> (i % 8)) & 1);
+      pos += TAG_BYTES;
+      return true;
+    }
+  };
+
+  /// Append encoded program to out.
+  static void Encode(const program_t & program, buffer_t & out) {
+    PutVarint(out, program.GetSize());
+    for (size_t fp = 0; fp < program.GetSize(); ++fp) {
+      const function_t & fun = program[fp];
+      PutTag(out, fun.GetAffinity());
+      PutVarint(out, fun.GetSize());
+      for (const inst_t & inst : fun.inst_seq) {
+        PutVarint(out, inst.id);
+        for (size_t i = 0; i < 3; ++i) PutSigned(out, inst.args[i]);
+        PutTag(out, inst.affinity);
+      }
+    }
+  }
+
+  /// 64-bit (FNV-1a) hash of a program's encoding (scratch is reused between calls to avoid allocations).
+  static uint64_t Hash(const program_t & program, buffer_t & scratch) {
+    scratch.clear();
+    Encode(program, scratch);
+    uint64_t hash = 14695981039346656037ull;
+    for (uint8_t byte : scratch) { hash ^= byte; hash *= 1099511628211ull; }
+    return hash;
+  }
+
+  /// Decode next program from reader into program (which must already have its instruction library).
+  /// Returns false if the buffer is truncated or names an instruction the library does not have.
+  static bool Decode(Reader & reader, program_t & program) {
+    program.Clear();
+    const size_t inst_lib_size = program.GetInstLib()->GetSize();
+    uint64_t fun_cnt, inst_cnt, id;
+    int64_t args[3];
+    affinity_t tag;
+    if (!reader.GetVarint(fun_cnt)) return false;
+    for (size_t fp = 0; fp < fun_cnt; ++fp) {
+      if (!reader.GetTag(tag) || !reader.GetVarint(inst_cnt)) return false;
+      program.PushFunction(function_t(tag));
+      for (size_t ip = 0; ip < inst_cnt; ++ip) {
+        if (!reader.GetVarint(id) || id >= inst_lib_size) return false;
+        for (size_t i = 0; i < 3; ++i) if (!reader.GetSigned(args[i])) return false;
+        if (!reader.GetTag(tag)) return false;
+        program.PushInst((size_t)id, (int)args[0], (int)args[1], (int)args[2], tag);
+      }
+    }
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef INST_DISPATCH_TABLE_H
+#define INST_DISPATCH_TABLE_H
+
+#include <string>
+#include <unordered_map>
+#include "base/Ptr.h"
+#include "base/vector.h"
+
+// How an instruction is executed by the fast core (see FastEventDrivenGP.h).
+// Block-defining instructions are executed by the core itself, using block ends resolved when the
+// program is decoded, rather than by their functions (which search for the end of the block every time).
+// Break is executed by the core because it needs the (decoded) function length.
+constexpr size_t INST_OP__DISPATCH = 0;   ///< Call the bound function.
+constexpr size_t INST_OP__NOP = 1;        ///< Do nothing.
+constexpr size_t INST_OP__IF = 2;         ///< EventDrivenGP_AW::Inst_If
+constexpr size_t INST_OP__WHILE = 3;      ///< EventDrivenGP_AW::Inst_While
+constexpr size_t INST_OP__COUNTDOWN = 4;  ///< EventDrivenGP_AW::Inst_Countdown
+constexpr size_t INST_OP__BREAK = 5;      ///< EventDrivenGP_AW::Inst_Break
+
+/// Dense instruction dispatch table for SignalGP hardware (see FastEventDrivenGP.h).
+/// Instructions are still registered with an emp::InstLib as usual (names, argument counts, properties,
+/// descriptions). Fast implementations are then bound by instruction name as plain function pointers
+/// that take their context explicitly, and the table is 'lowered' against the instruction library:
+/// entry i holds the binding for instruction ID i. Instructions without a binding fall back to the
+/// instruction library's (std::function) implementation, so every registered instruction keeps working.
+template <typename HARDWARE>
+class InstDispatchTable {
+public:
+  using hardware_t = HARDWARE;
+  using inst_t = typename hardware_t::inst_t;
+  using inst_lib_t = typename hardware_t::inst_lib_t;
+  using fun_t = void (*)(void * ctx, size_t param, hardware_t & hw, const inst_t & inst);
+
+  struct Entry {
+    fun_t fun;
+    void * ctx;     ///< Context passed to fun (e.g., the experiment).
+    size_t param;   ///< Extra parameter passed to fun (e.g., the state ID of SetState-i).
+    size_t op;      ///< INST_OP__*
+  };
+
+protected:
+  emp::vector<Entry> table;                       ///< Instruction ID => entry.
+  std::unordered_map<std::string, Entry> bindings; ///< Instruction name => entry.
+  size_t bound_cnt;                               ///< Number of table entries with a fast binding.
+
+  template <void (*FUN)(hardware_t &, const inst_t &)>
+  static void CallFun(void *, size_t, hardware_t & hw, const inst_t & inst) { FUN(hw, inst); }
+
+  template <typename CONTEXT, void (CONTEXT::*FUN)(hardware_t &, const inst_t &)>
+  static void CallMember(void * ctx, size_t, hardware_t & hw, const inst_t & inst) {
+    (static_cast<CONTEXT *>(ctx)->*FUN)(hw, inst);
+  }
+
+  template <typename CONTEXT, void (*FUN)(CONTEXT &, size_t, hardware_t &, const inst_t &)>
+  static void CallParam(void * ctx, size_t param, hardware_t & hw, const inst_t & inst) {
+    FUN(*static_cast<CONTEXT *>(ctx), param, hw, inst);
+  }
+
+  static void CallInstLib(void * ctx, size_t, hardware_t & hw, const inst_t & inst) {
+    static_cast<const inst_lib_t *>(ctx)->ProcessInst(hw, inst);
+  }
+
+public:
+  InstDispatchTable() : table(), bindings(), bound_cnt(0) { ; }
+
+  size_t GetSize() const { return table.size(); }
+  size_t GetBoundCnt() const { return bound_cnt; }
+  bool IsBound(const std::string & name) const { return bindings.count(name); }
+  const Entry & GetEntry(size_t inst_id) const { return table[inst_id]; }
+
+  /// Bind instruction to a plain function (e.g., hardware_t::Inst_Inc).
+  /// If op is not INST_OP__DISPATCH, FUN must behave exactly like the op's default instruction.
+  template <void (*FUN)(hardware_t &, const inst_t &)>
+  void BindFun(const std::string & name, size_t op=INST_OP__DISPATCH) {
+    bindings[name] = Entry{&CallFun<FUN>, nullptr, 0, op};
+  }
+
+  /// Bind instruction to a member function of ctx.
+  template <typename CONTEXT, void (CONTEXT::*FUN)(hardware_t &, const inst_t &)>
+  void BindMember(const std::string & name, CONTEXT & ctx) {
+    bindings[name] = Entry{&CallMember<CONTEXT, FUN>, &ctx, 0, INST_OP__DISPATCH};
+  }
+
+  /// Bind instruction to a function of (ctx, param); lets one function serve a family of instructions.
+  template <typename CONTEXT, void (*FUN)(CONTEXT &, size_t, hardware_t &, const inst_t &)>
+  void BindParam(const std::string & name, CONTEXT & ctx, size_t param) {
+    bindings[name] = Entry{&CallParam<CONTEXT, FUN>, &ctx, param, INST_OP__DISPATCH};
+  }
+
+  /// Bind EventDrivenGP's default instructions (under their default names).
+  /// NOTE: Only use if these names were registered with hardware_t's default implementations.
+  void BindDefaults() {
+    BindFun<hardware_t::Inst_Inc>("Inc");
+    BindFun<hardware_t::Inst_Dec>("Dec");
+    BindFun<hardware_t::Inst_Not>("Not");
+    BindFun<hardware_t::Inst_Add>("Add");
+    BindFun<hardware_t::Inst_Sub>("Sub");
+    BindFun<hardware_t::Inst_Mult>("Mult");
+    BindFun<hardware_t::Inst_Div>("Div");
+    BindFun<hardware_t::Inst_Mod>("Mod");
+    BindFun<hardware_t::Inst_TestEqu>("TestEqu");
+    BindFun<hardware_t::Inst_TestNEqu>("TestNEqu");
+    BindFun<hardware_t::Inst_TestLess>("TestLess");
+    BindFun<hardware_t::Inst_If>("If", INST_OP__IF);
+    BindFun<hardware_t::Inst_While>("While", INST_OP__WHILE);
+    BindFun<hardware_t::Inst_Countdown>("Countdown", INST_OP__COUNTDOWN);
+    BindFun<hardware_t::Inst_Close>("Close");
+    BindFun<hardware_t::Inst_Break>("Break", INST_OP__BREAK);
+    BindFun<hardware_t::Inst_Call>("Call");
+    BindFun<hardware_t::Inst_Return>("Return");
+    BindFun<hardware_t::Inst_SetMem>("SetMem");
+    BindFun<hardware_t::Inst_CopyMem>("CopyMem");
+    BindFun<hardware_t::Inst_SwapMem>("SwapMem");
+    BindFun<hardware_t::Inst_Input>("Input");
+    BindFun<hardware_t::Inst_Output>("Output");
+    BindFun<hardware_t::Inst_Commit>("Commit");
+    BindFun<hardware_t::Inst_Pull>("Pull");
+    BindFun<hardware_t::Inst_Nop>("Nop", INST_OP__NOP);
+  }
+
+  /// Build the dense table for the given instruction library. Must be re-lowered if instructions are
+  /// added to the library afterward.
+  void Lower(emp::Ptr<const inst_lib_t> inst_lib) {
+    table.resize(inst_lib->GetSize());
+    bound_cnt = 0;
+    for (size_t id = 0; id < table.size(); ++id) {
+      auto it = bindings.find(inst_lib->GetName(id));
+      if (it != bindings.end()) {
+        table[id] = it->second;
+        ++bound_cnt;
+      } else {
+        table[id] = Entry{&CallInstLib, const_cast<inst_lib_t *>(inst_lib.Raw()), 0, INST_OP__DISPATCH};
+      }
+    }
+  }
+
+  void Execute(hardware_t & hw, const inst_t & inst) const {
+    const Entry & entry = table[inst.id];
+    entry.fun(entry.ctx, entry.param, hw, inst);
+  }
+};
+
+#endif
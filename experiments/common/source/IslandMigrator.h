@@ -0,0 +1,77 @@
+#ifndef ISLAND_MIGRATOR_H
+#define ISLAND_MIGRATOR_H
+
+#include <iostream>
+#include <string>
+#include "base/vector.h"
+#include "tools/Random.h"
+
+#include "IslandRing.h"
+
+/// Island-model migration for a world of SignalGP agents (WORLD: emp::World; CODEC: GenomeCodec over the
+/// world's genome type). Every Migrate, migrant_cnt randomly chosen genomes are encoded and sent to the next
+/// island of an IslandRing, and the previous island's migrants replace randomly chosen agents.
+template <typename WORLD, typename CODEC>
+class IslandMigrator {
+public:
+  using world_t = WORLD;
+  using codec_t = CODEC;
+  using genome_t = typename world_t::genome_t;
+  using buffer_t = IslandRing::buffer_t;
+
+protected:
+  IslandRing ring;
+  size_t migrant_cnt;
+  buffer_t emigrant_buffer;
+  buffer_t immigrant_buffer;
+
+public:
+  /// max_genome_bytes: largest encoding of a genome (e.g., codec_t::GetMaxBytes(max funcs, max insts)).
+  IslandMigrator(const std::string & name, size_t island_cnt, size_t island_id, size_t _migrant_cnt,
+                 size_t max_genome_bytes)
+    : ring(name, island_cnt, island_id, codec_t::MAX_VARINT_BYTES + _migrant_cnt * max_genome_bytes),
+      migrant_cnt(_migrant_cnt), emigrant_buffer(), immigrant_buffer() { ; }
+
+  IslandMigrator(const IslandMigrator &) = delete;
+  IslandMigrator & operator=(const IslandMigrator &) = delete;
+
+  size_t GetMigrantCnt() const { return migrant_cnt; }
+
+  /// Join the island ring (see IslandRing::Open).
+  bool Open(std::ostream & err=std::cerr) { return ring.Open(err); }
+  void Close() { ring.Close(); }
+
+  /// Exchange migrants with the other islands. immigrant is used to decode immigrants (so it should be a
+  /// genome that uses the world's instruction library), and on_inject(pos) is called after each immigrant
+  /// is placed. Returns false (saying why on err) if the exchange failed or the migrants were malformed.
+  template <typename ON_INJECT>
+  bool Migrate(world_t & world, emp::Random & random, genome_t & immigrant, ON_INJECT && on_inject,
+               std::ostream & err=std::cerr) {
+    emigrant_buffer.clear();
+    codec_t::PutVarint(emigrant_buffer, migrant_cnt);
+    for (size_t i = 0; i < migrant_cnt; ++i) {
+      codec_t::Encode(world.GetOrg(random.GetUInt(world.GetSize())).GetGenome(), emigrant_buffer);
+    }
+    if (!ring.Exchange(emigrant_buffer.data(), emigrant_buffer.size(), immigrant_buffer)) {
+      err << "Failed to exchange migrants with other islands." << std::endl;
+      return false;
+    }
+    typename codec_t::Reader reader(immigrant_buffer.data(), immigrant_buffer.data() + immigrant_buffer.size());
+    uint64_t immigrant_cnt = 0;
+    bool valid = reader.GetVarint(immigrant_cnt);
+    for (size_t i = 0; valid && i < immigrant_cnt; ++i) {
+      valid = codec_t::Decode(reader, immigrant);
+      if (!valid) break;
+      const size_t pos = random.GetUInt(world.GetSize());
+      world.InjectAt(immigrant, emp::WorldPosition(pos));
+      on_inject(pos);
+    }
+    if (!valid) {
+      err << "Received malformed migrants." << std::endl;
+      return false;
+    }
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef ISLAND_RING_H
+#define ISLAND_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "base/vector.h"
+
+/// Migration ring for island-model runs: island_cnt processes (on the same machine) share one POSIX
+/// shared memory segment holding one slot per island. Every Exchange, island i writes its migrants to
+/// its own slot and reads island i-1's migrants (so migrants travel around the ring i -> i+1).
+/// - Exchanges are numbered (epochs); a slot is only rewritten once its reader has read the previous
+///   epoch and only read once its writer has written the current epoch. What each island receives
+///   therefore does not depend on process timing.
+/// - Island 0 creates the segment (removing any stale one left by a killed run); the others wait for
+///   it. Open returns once every island has attached. The last island to Close removes the segment.
+/// - Another island may find a stale segment before island 0 has replaced it. So an island only counts as
+///   attached once island 0 has acknowledged a (per-process) join nonce that the island wrote into its slot;
+///   until then, it keeps checking whether the segment has been replaced (and, if so, maps the new one).
+/// - Waits give up (and report failure) after timeout_sec seconds, e.g., if another island died.
+class IslandRing {
+public:
+  using buffer_t = emp::vector<uint8_t>;
+
+protected:
+  static constexpr uint64_t MAGIC = 0x5347504953524E47ull;  // "SGPISRNG"
+  static constexpr size_t HEADER_BYTES = 64;
+
+  struct Header {
+    std::atomic<uint64_t> magic;      ///< Set (last) once island 0 has initialized the segment.
+    uint64_t island_cnt;
+    uint64_t slot_bytes;
+    std::atomic<uint64_t> attached;   ///< Number of islands currently attached.
+  };
+
+  struct Slot {
+    std::atomic<uint64_t> written_epoch;  ///< Last epoch written by owner.
+    std::atomic<uint64_t> read_epoch;     ///< Last epoch read by owner's successor.
+    uint64_t size;                        ///< Bytes of data in this slot.
+    std::atomic<uint64_t> join_nonce;     ///< Written by owner (other than island 0) to join.
+    std::atomic<uint64_t> join_ack;       ///< Set to join_nonce by island 0 to accept owner.
+  };
+
+  static_assert(sizeof(Header) <= HEADER_BYTES && sizeof(Slot) <= HEADER_BYTES, "Ring headers too big.");
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared memory ring needs lock-free 64-bit atomics.");
+
+  std::string name;
+  size_t island_cnt;
+  size_t island_id;
+  size_t slot_bytes;
+  double timeout_sec;
+  uint64_t epoch;
+  int fd;
+  uint8_t * base;
+  size_t map_bytes;
+
+  Header & GetHeader() { return *reinterpret_cast<Header*>(base); }
+  Slot & GetSlot(size_t id) { return *reinterpret_cast<Slot*>(base + HEADER_BYTES + id * (HEADER_BYTES + slot_bytes)); }
+  uint8_t * GetSlotData(size_t id) { return base + HEADER_BYTES + id * (HEADER_BYTES + slot_bytes) + HEADER_BYTES; }
+
+  /// Wait until done() is true (or timeout).
+  template <typename FUN>
+  bool WaitFor(FUN done) const {
+    const auto start = std::chrono::steady_clock::now();
+    size_t spins = 0;
+    while (!done()) {
+      if (++spins < 1000) { std::this_thread::yield(); continue; }
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > timeout_sec) return false;
+    }
+    return true;
+  }
+
+  void Unmap() {
+    if (base) munmap(base, map_bytes);
+    if (fd >= 0) close(fd);
+    base = nullptr;
+    fd = -1;
+  }
+
+  /// Has the segment we mapped been removed or replaced (e.g., we mapped a stale one and island 0 has
+  /// since created a new one)?
+  bool IsReplaced() const {
+    const int cur_fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (cur_fd < 0) return true;
+    struct stat cur_info, info;
+    const bool replaced = fstat(cur_fd, &cur_info) != 0 || fstat(fd, &info) != 0
+                          || cur_info.st_ino != info.st_ino || cur_info.st_dev != info.st_dev;
+    close(cur_fd);
+    return replaced;
+  }
+
+  /// Island 0: accept every island that has written a join nonce.
+  void AckJoins() {
+    for (size_t i = 1; i < island_cnt; ++i) {
+      Slot & slot = GetSlot(i);
+      const uint64_t nonce = slot.join_nonce.load(std::memory_order_acquire);
+      if (nonce && slot.join_ack.load(std::memory_order_relaxed) != nonce) slot.join_ack.store(nonce, std::memory_order_release);
+    }
+  }
+
+  static uint64_t MakeNonce() {
+    const uint64_t time = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    return (((uint64_t)getpid() << 32) ^ time) | 1;
+  }
+
+  bool Map(int flags, std::ostream & err) {
+    fd = shm_open(name.c_str(), flags, 0600);
+    if (fd < 0) return false;
+    if (flags & O_CREAT) {
+      if (ftruncate(fd, (off_t)map_bytes) != 0) { err << "IslandRing: failed to size " << name << std::endl; Unmap(); return false; }
+    } else {
+      struct stat info;
+      if (fstat(fd, &info) != 0 || (size_t)info.st_size < map_bytes) { close(fd); fd = -1; return false; }
+    }
+    void * ptr = mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) { err << "IslandRing: failed to map " << name << std::endl; Unmap(); return false; }
+    base = static_cast<uint8_t*>(ptr);
+    return true;
+  }
+
+public:
+  IslandRing(const std::string & _name, size_t _island_cnt, size_t _island_id, size_t _slot_bytes=(1 << 20),
+             double _timeout_sec=3600)
+    : name(_name), island_cnt(_island_cnt), island_id(_island_id), slot_bytes(_slot_bytes),
+      timeout_sec(_timeout_sec), epoch(0), fd(-1), base(nullptr),
+      map_bytes(HEADER_BYTES + _island_cnt * (HEADER_BYTES + _slot_bytes))
+  {
+    if (name.empty() || name[0] != '/') name = "/" + name;
+  }
+
+  ~IslandRing() { Close(); }
+
+  IslandRing(const IslandRing &) = delete;
+  IslandRing & operator=(const IslandRing &) = delete;
+
+  bool IsOpen() const { return base != nullptr; }
+  size_t GetSlotBytes() const { return slot_bytes; }
+  size_t GetIslandCnt() const { return island_cnt; }
+  size_t GetIslandID() const { return island_id; }
+
+  /// Create (island 0) or attach to (other islands) the ring, then wait for all islands to attach.
+  bool Open(std::ostream & err=std::cerr) {
+    if (IsOpen()) return true;
+    if (island_id >= island_cnt) { err << "IslandRing: island " << island_id << " out of range." << std::endl; return false; }
+    if (island_id == 0) {
+      shm_unlink(name.c_str());
+      if (!Map(O_CREAT | O_EXCL | O_RDWR, err)) { err << "IslandRing: failed to create " << name << std::endl; return false; }
+      std::memset(base, 0, map_bytes);
+      Header & header = *new (base) Header();
+      header.island_cnt = island_cnt;
+      header.slot_bytes = slot_bytes;
+      header.attached.store(0);
+      for (size_t i = 0; i < island_cnt; ++i) {
+        Slot & slot = *new (base + HEADER_BYTES + i * (HEADER_BYTES + slot_bytes)) Slot();
+        slot.written_epoch.store(0);
+        slot.read_epoch.store(0);
+        slot.size = 0;
+        slot.join_nonce.store(0);
+        slot.join_ack.store(0);
+      }
+      header.magic.store(MAGIC, std::memory_order_release);
+    } else {
+      // Join: write nonce into our slot, and wait for island 0 to acknowledge it. (Segments that island 0
+      // never acknowledges are stale; they get replaced once island 0 starts.)
+      const uint64_t nonce = MakeNonce();
+      bool other_settings = false;
+      const bool joined = WaitFor([this, &err, nonce, &other_settings]() {
+        if (IsOpen() && IsReplaced()) Unmap();
+        if (!IsOpen() && !Map(O_RDWR, err)) return false;
+        Header & header = GetHeader();
+        if (header.magic.load(std::memory_order_acquire) != MAGIC) return false;
+        other_settings = header.island_cnt != island_cnt || header.slot_bytes != slot_bytes;
+        if (other_settings) return false;
+        Slot & slot = GetSlot(island_id);
+        if (slot.join_nonce.load(std::memory_order_relaxed) != nonce) slot.join_nonce.store(nonce, std::memory_order_release);
+        return slot.join_ack.load(std::memory_order_acquire) == nonce;
+      });
+      if (!joined) {
+        if (other_settings) err << "IslandRing: " << name << " was created with different settings." << std::endl;
+        else err << "IslandRing: timed out waiting for island 0 to create " << name << std::endl;
+        Unmap();
+        return false;
+      }
+    }
+    GetHeader().attached.fetch_add(1);
+    if (!WaitFor([this]() {
+          if (island_id == 0) AckJoins();
+          return GetHeader().attached.load() >= island_cnt;
+        })) {
+      err << "IslandRing: timed out waiting for all " << island_cnt << " islands to attach to " << name << std::endl;
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  /// Detach from the ring (removing it if this is the last island attached).
+  void Close() {
+    if (!IsOpen()) return;
+    if (GetHeader().attached.fetch_sub(1) == 1) shm_unlink(name.c_str());
+    Unmap();
+  }
+
+  /// Send size bytes (at most GetSlotBytes()) to the next island and receive the previous island's
+  /// bytes (into in). Every island must call Exchange the same number of times.
+  bool Exchange(const uint8_t * data, size_t size, buffer_t & in) {
+    if (!IsOpen() || size > slot_bytes) return false;
+    ++epoch;
+    const uint64_t cur_epoch = epoch;
+    Slot & out_slot = GetSlot(island_id);
+    if (!WaitFor([&out_slot, cur_epoch]() { return out_slot.read_epoch.load(std::memory_order_acquire) + 1 >= cur_epoch; })) return false;
+    std::memcpy(GetSlotData(island_id), data, size);
+    out_slot.size = size;
+    out_slot.written_epoch.store(cur_epoch, std::memory_order_release);
+    const size_t src_id = (island_id + island_cnt - 1) % island_cnt;
+    Slot & in_slot = GetSlot(src_id);
+    if (!WaitFor([&in_slot, cur_epoch]() { return in_slot.written_epoch.load(std::memory_order_acquire) >= cur_epoch; })) return false;
+    const uint8_t * src = GetSlotData(src_id);
+    in.assign(src, src + in_slot.size);
+    in_slot.read_epoch.store(cur_epoch, std::memory_order_release);
+    return true;
+  }
+};
+
+#endif
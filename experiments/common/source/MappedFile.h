@@ -0,0 +1,58 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Read-only memory map of a whole file. Empty files open fine (with no data); missing or unreadable
+/// files do not (IsOpen() is false).
+class MappedFile {
+protected:
+  const char * data;
+  size_t size;
+  bool open;
+
+public:
+  MappedFile() : data(nullptr), size(0), open(false) { ; }
+  MappedFile(const std::string & path) : MappedFile() { Open(path); }
+  ~MappedFile() { Close(); }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile & operator=(const MappedFile &) = delete;
+
+  bool IsOpen() const { return open; }
+  const char * GetData() const { return data; }
+  const char * GetEnd() const { return data + size; }
+  size_t GetSize() const { return size; }
+
+  bool Open(const std::string & path) {
+    Close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) { ::close(fd); return false; }
+    size = (size_t)info.st_size;
+    if (size) {
+      void * ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (ptr == MAP_FAILED) { ::close(fd); size = 0; return false; }
+      data = static_cast<const char*>(ptr);
+      madvise(ptr, size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+    open = true;
+    return true;
+  }
+
+  void Close() {
+    if (data) munmap(const_cast<char*>(data), size);
+    data = nullptr;
+    size = 0;
+    open = false;
+  }
+};
+
+#endif
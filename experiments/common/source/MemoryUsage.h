@@ -0,0 +1,100 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+/// Memory accounting: estimates of the heap bytes held by the experiments' major containers (the
+/// world's programs, systematics, phenotype caches, hardware, inboxes) plus the process's resident set
+/// size, for sizing cluster requests (see MEMORY_REPORT_INTERVAL).
+///
+/// Estimates are walked from container capacities when asked for (rather than tracked by counting
+/// allocators), so they cost nothing between reports. They count payload only: allocator headers and
+/// fragmentation show up in the RSS columns instead. Functions here return heap bytes owned by an object,
+/// not counting sizeof the object itself.
+namespace memory_usage {
+  /// Rough per-node overhead of node-based containers (next pointer and cached hash/padding).
+  constexpr size_t NODE_OVERHEAD = 2 * sizeof(void*);
+  /// Rough size of an emp::Taxon's bookkeeping (ID, counts, depth, parent pointer, set nodes), not
+  /// counting its genome.
+  constexpr size_t TAXON_BYTES = 12 * sizeof(size_t);
+
+  template <typename T, typename ALLOC>
+  size_t VectorBytes(const std::vector<T, ALLOC> & vec) { return vec.capacity() * sizeof(T); }
+
+  /// (Counts elements only; deques allocate in fixed-size chunks.)
+  template <typename T, typename ALLOC>
+  size_t DequeBytes(const std::deque<T, ALLOC> & deq) { return deq.size() * sizeof(T); }
+
+  /// std::unordered_map/std::unordered_set: bucket array plus one node per element.
+  template <typename HASH_CONTAINER>
+  size_t HashBytes(const HASH_CONTAINER & container) {
+    return container.bucket_count() * sizeof(void*)
+           + container.size() * (sizeof(typename HASH_CONTAINER::value_type) + NODE_OVERHEAD);
+  }
+
+  /// SignalGP program (function vector and instruction sequences).
+  template <typename PROGRAM>
+  size_t ProgramBytes(const PROGRAM & program) {
+    size_t bytes = VectorBytes(program.program);
+    for (const auto & fun : program.program) bytes += VectorBytes(fun.inst_seq);
+    return bytes;
+  }
+
+  /// SignalGP call state (memory maps and block stack).
+  template <typename STATE>
+  size_t StateBytes(const STATE & state) {
+    return HashBytes(state.local_mem) + HashBytes(state.input_mem) + HashBytes(state.output_mem)
+           + VectorBytes(state.block_stack);
+  }
+
+  /// SignalGP event (message and properties).
+  template <typename EVENT>
+  size_t EventBytes(const EVENT & event) {
+    return HashBytes(event.msg) + HashBytes(event.properties);
+  }
+
+  /// SignalGP cores (call stacks).
+  template <typename EXEC_STK, typename ALLOC>
+  size_t CoresBytes(const std::vector<EXEC_STK, ALLOC> & cores) {
+    size_t bytes = VectorBytes(cores);
+    for (const EXEC_STK & stk : cores) {
+      bytes += VectorBytes(stk);
+      for (const auto & state : stk) bytes += StateBytes(state);
+    }
+    return bytes;
+  }
+
+  /// Queue of SignalGP events.
+  template <typename EVENT, typename ALLOC>
+  size_t EventQueueBytes(const std::deque<EVENT, ALLOC> & queue) {
+    size_t bytes = DequeBytes(queue);
+    for (const EVENT & event : queue) bytes += EventBytes(event);
+    return bytes;
+  }
+
+  /// Resident set size (current and peak, in bytes) from /proc/self/status. Both are 0 where
+  /// /proc is not available.
+  struct ProcMemory {
+    size_t rss = 0;
+    size_t peak_rss = 0;
+  };
+
+  inline ProcMemory ReadProcMemory() {
+    ProcMemory mem;
+    FILE * status = std::fopen("/proc/self/status", "r");
+    if (!status) return mem;
+    char line[256];
+    size_t kb = 0;
+    while (std::fgets(line, sizeof(line), status)) {
+      if (std::strncmp(line, "VmRSS:", 6) == 0 && std::sscanf(line + 6, "%zu", &kb) == 1) mem.rss = kb * 1024;
+      else if (std::strncmp(line, "VmHWM:", 6) == 0 && std::sscanf(line + 6, "%zu", &kb) == 1) mem.peak_rss = kb * 1024;
+    }
+    std::fclose(status);
+    return mem;
+  }
+}
+
+#endif
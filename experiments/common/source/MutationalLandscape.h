@@ -0,0 +1,202 @@
+#ifndef MUTATIONAL_LANDSCAPE_H
+#define MUTATIONAL_LANDSCAPE_H
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include "base/vector.h"
+
+#include "GenomeCodec.h"
+
+/// Single-step variants of a program for mutational landscape (knockout) analyses:
+/// - knockouts: each instruction in turn replaced by a no-op (arguments and tag are kept);
+/// - function deletions: each function in turn removed;
+/// - mutants: random mutants, each the result of one application of the experiment's mutation operator
+///   (i.e., an offspring's worth of mutations at the configured rates).
+/// Each variant is attributed to a site (function, position); mutant sites are the first place the mutant
+/// differs from the parent (see the mutations column for how many other changes it carries). Variants with identical genomes (e.g., knockouts of existing no-ops or
+/// mutants that reproduce the parent) share one evaluation, so only GetEvalCnt() programs need evaluating.
+template <typename HARDWARE>
+class MutationalLandscape {
+public:
+  using hardware_t = HARDWARE;
+  using program_t = typename hardware_t::program_t;
+  using function_t = typename hardware_t::Function;
+  using inst_t = typename hardware_t::inst_t;
+  using codec_t = GenomeCodec<hardware_t>;
+
+  enum VariantType { VARIANT_PARENT = 0, VARIANT_KNOCKOUT, VARIANT_FUNC_DELETION, VARIANT_MUTANT };
+
+  static constexpr size_t NO_SITE = (size_t)-1;
+
+  struct Variant {
+    VariantType type;
+    size_t func;     ///< Site function (NO_SITE for the parent).
+    size_t inst;     ///< Site position in function (NO_SITE for the parent, function deletions, and tag mutants).
+    size_t mut_cnt;  ///< Number of mutations (as counted by the mutation operator for mutants).
+    size_t eval_id;  ///< Evaluation (distinct program) this variant shares.
+  };
+
+protected:
+  emp::vector<Variant> variants;
+  emp::vector<program_t> programs;                ///< By evaluation (programs[0] is the parent).
+  emp::vector<size_t> eval_variants;              ///< By evaluation: first variant with that program.
+  std::unordered_multimap<uint64_t, size_t> eval_ids;  ///< Program hash => evaluations.
+  typename codec_t::buffer_t scratch;
+  size_t failed_mutant_cnt;
+
+  void AddVariant(VariantType type, size_t func, size_t inst, size_t mut_cnt, const program_t & program) {
+    const uint64_t hash = codec_t::Hash(program, scratch);
+    // Only share an evaluation with a program that is actually identical (hashes can collide).
+    auto range = eval_ids.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (SameProgram(programs[it->second], program)) {
+        variants.emplace_back(Variant{type, func, inst, mut_cnt, it->second});
+        return;
+      }
+    }
+    eval_ids.emplace(hash, programs.size());
+    variants.emplace_back(Variant{type, func, inst, mut_cnt, programs.size()});
+    programs.emplace_back(program);
+    eval_variants.emplace_back(variants.size() - 1);
+  }
+
+  static bool SameInst(const inst_t & a, const inst_t & b) {
+    return a.id == b.id && a.args[0] == b.args[0] && a.args[1] == b.args[1] && a.args[2] == b.args[2]
+           && a.affinity == b.affinity;
+  }
+
+  static bool SameProgram(const program_t & a, const program_t & b) {
+    size_t func, inst;
+    FindSite(a, b, func, inst);
+    return func == NO_SITE;
+  }
+
+public:
+  MutationalLandscape(const program_t & parent)
+    : variants(), programs(), eval_variants(), eval_ids(), scratch(), failed_mutant_cnt(0)
+  {
+    AddVariant(VARIANT_PARENT, NO_SITE, NO_SITE, 0, parent);
+  }
+
+  size_t GetVariantCnt() const { return variants.size(); }
+  size_t GetEvalCnt() const { return programs.size(); }
+  size_t GetFailedMutantCnt() const { return failed_mutant_cnt; }
+  const Variant & GetVariant(size_t id) const { return variants[id]; }
+  const program_t & GetParent() const { return programs[0]; }
+  const program_t & GetProgram(size_t eval_id) const { return programs[eval_id]; }
+  /// First variant evaluated with eval_id's program (e.g., to tell whether evaluation is of a knockout).
+  const Variant & GetEvalVariant(size_t eval_id) const { return variants[eval_variants[eval_id]]; }
+
+  static std::string GetTypeName(VariantType type) {
+    switch (type) {
+      case VARIANT_PARENT: return "parent";
+      case VARIANT_KNOCKOUT: return "knockout";
+      case VARIANT_FUNC_DELETION: return "func_deletion";
+      default: return "mutant";
+    }
+  }
+
+  /// Add a knockout of every instruction (replaced with instruction nop_id).
+  void AddKnockouts(size_t nop_id) {
+    const program_t parent(GetParent());  // (Adding variants may move programs.)
+    program_t variant(parent);
+    for (size_t fp = 0; fp < parent.GetSize(); ++fp) {
+      for (size_t ip = 0; ip < parent[fp].GetSize(); ++ip) {
+        variant[fp][ip].id = nop_id;
+        AddVariant(VARIANT_KNOCKOUT, fp, ip, 1, variant);
+        variant[fp][ip].id = parent[fp][ip].id;
+      }
+    }
+  }
+
+  /// Add a deletion of every function (unless parent has only one function).
+  void AddFunctionDeletions() {
+    const program_t parent(GetParent());
+    if (parent.GetSize() < 2) return;
+    for (size_t fp = 0; fp < parent.GetSize(); ++fp) {
+      program_t variant(parent);
+      variant.program.erase(variant.program.begin() + fp);
+      AddVariant(VARIANT_FUNC_DELETION, fp, NO_SITE, 1, variant);
+    }
+  }
+
+  /// Add cnt random mutants. mutate(program) mutates program and returns the number of mutations; a mutant
+  /// is redrawn while it is identical to the parent (up to max_tries times, after which it is skipped and
+  /// counted in GetFailedMutantCnt()).
+  template <typename MUTATE>
+  void AddMutants(size_t cnt, MUTATE && mutate, size_t max_tries=1000) {
+    const program_t parent(GetParent());
+    for (size_t i = 0; i < cnt; ++i) {
+      bool found = false;
+      for (size_t tries = 0; tries < max_tries && !found; ++tries) {
+        program_t variant(parent);
+        const size_t mut_cnt = mutate(variant);
+        size_t func, inst;
+        FindSite(parent, variant, func, inst);
+        if (func == NO_SITE) continue;
+        AddVariant(VARIANT_MUTANT, func, inst, mut_cnt, variant);
+        found = true;
+      }
+      if (!found) ++failed_mutant_cnt;
+    }
+  }
+
+  /// First site at which b differs from a: (function, position) of the first differing instruction, or
+  /// (function, NO_SITE) if only the function's tag differs. (NO_SITE, NO_SITE) if they do not differ.
+  static void FindSite(const program_t & a, const program_t & b, size_t & func, size_t & inst) {
+    func = inst = NO_SITE;
+    const size_t fun_cnt = std::min(a.GetSize(), b.GetSize());
+    for (size_t fp = 0; fp < fun_cnt; ++fp) {
+      const function_t & fa = a[fp];
+      const function_t & fb = b[fp];
+      const size_t len = std::min(fa.GetSize(), fb.GetSize());
+      for (size_t ip = 0; ip < len; ++ip) {
+        if (!SameInst(fa.inst_seq[ip], fb.inst_seq[ip])) { func = fp; inst = ip; return; }
+      }
+      if (fa.GetSize() != fb.GetSize()) { func = fp; inst = len; return; }
+      if (!(fa.GetAffinity() == fb.GetAffinity())) { func = fp; return; }
+    }
+    if (a.GetSize() != b.GetSize()) func = fun_cnt;
+  }
+
+  /// Write per-site sensitivity table (one row per variant) given each evaluation's mean and minimum
+  /// fitness. Deltas are relative to the parent.
+  void PrintTable(std::ostream & os, const emp::vector<double> & eval_mean, const emp::vector<double> & eval_min) const {
+    const program_t & parent = GetParent();
+    os << "variant,type,function,inst,inst_name,mutations,mean_fitness,min_fitness,delta_mean_fitness,delta_min_fitness";
+    for (size_t vID = 0; vID < variants.size(); ++vID) {
+      const Variant & variant = variants[vID];
+      os << "\n" << vID << "," << GetTypeName(variant.type) << ",";
+      if (variant.func != NO_SITE) os << variant.func;
+      os << ",";
+      if (variant.inst != NO_SITE) os << variant.inst;
+      os << ",";
+      if (variant.func < parent.GetSize() && variant.inst < parent[variant.func].GetSize()) {
+        os << parent.GetInstLib()->GetName(parent[variant.func][variant.inst].id);
+      }
+      os << "," << variant.mut_cnt << "," << eval_mean[variant.eval_id] << "," << eval_min[variant.eval_id]
+         << "," << (eval_mean[variant.eval_id] - eval_mean[0]) << "," << (eval_min[variant.eval_id] - eval_min[0]);
+    }
+    os << "\n";
+  }
+
+  /// Print, by variant type, how many variants lower/keep/raise mean fitness relative to the parent.
+  void PrintSummary(std::ostream & os, const emp::vector<double> & eval_mean) const {
+    for (VariantType type : {VARIANT_KNOCKOUT, VARIANT_FUNC_DELETION, VARIANT_MUTANT}) {
+      size_t lower = 0, same = 0, higher = 0;
+      for (const Variant & variant : variants) {
+        if (variant.type != type) continue;
+        const double mean = eval_mean[variant.eval_id];
+        if (mean < eval_mean[0]) ++lower;
+        else if (mean > eval_mean[0]) ++higher;
+        else ++same;
+      }
+      os << GetTypeName(type) << ": " << (lower + same + higher) << " variants; " << lower << " deleterious, "
+         << same << " neutral, " << higher << " beneficial" << std::endl;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,255 @@
+#ifndef PROGRAM_LOADER_H
+#define PROGRAM_LOADER_H
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include "base/Ptr.h"
+#include "base/vector.h"
+
+#include "MappedFile.h"
+
+/// Fast loader for SignalGP program files: .gp files (one program, as written by PrintProgramFull) and
+/// population snapshots (.pop files: programs separated by '===' lines). Files are memory-mapped and
+/// tokenized in place, and instruction names are resolved with a perfect hash of the instruction
+/// library's names (built when the loader is made, so the library must be complete by then).
+///
+/// Accepts what Program::Load accepts (blank lines, '//' and '#' comments, any spacing), but instead of
+/// guessing at malformed lines (unknown instructions, bad arguments or tags), stops and reports where
+/// the problem is (see GetError).
+template <typename HARDWARE>
+class ProgramLoader {
+public:
+  using hardware_t = HARDWARE;
+  using program_t = typename hardware_t::program_t;
+  using function_t = typename hardware_t::Function;
+  using inst_t = typename hardware_t::inst_t;
+  using inst_lib_t = typename hardware_t::inst_lib_t;
+  using affinity_t = typename hardware_t::affinity_t;
+
+  static constexpr size_t NO_INST = (size_t)-1;
+  static constexpr size_t MAX_ARGS = 3;
+
+protected:
+  emp::Ptr<const inst_lib_t> inst_lib;
+  emp::vector<std::string> names;   ///< Hashed names (by slot).
+  emp::vector<size_t> ids;          ///< Instruction ID (by slot; NO_INST for empty slots).
+  uint64_t seed;                    ///< Hash seed that gives no collisions.
+  uint64_t mask;                    ///< Table size - 1.
+
+  std::string error;
+
+  static uint64_t Hash(const char * begin, const char * end, uint64_t seed) {
+    uint64_t hash = 14695981039346656037ull ^ seed;
+    for (const char * c = begin; c < end; ++c) { hash ^= (uint8_t)*c; hash *= 1099511628211ull; }
+    return hash ^ (hash >> 29);
+  }
+
+  static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+  /// Location of a parse error: set error and return false.
+  bool Fail(const std::string & where, size_t line, const char * line_begin, const char * pos, const std::string & msg) {
+    error = where + ":" + std::to_string(line) + ":" + std::to_string((size_t)(pos - line_begin) + 1) + ": " + msg;
+    return false;
+  }
+
+  /// Parse a tag (exactly affinity_t::GetSize() 0/1 characters, highest bit first) starting at pos.
+  bool ParseTag(const char *& pos, const char * end, affinity_t & tag) {
+    tag = affinity_t();
+    const size_t width = affinity_t::GetSize();
+    for (size_t i = 0; i < width; ++i, ++pos) {
+      if (pos == end || (*pos != '0' && *pos != '1')) return false;
+      if (*pos == '1') tag.Set(width - i - 1, true);
+    }
+    return pos == end || (*pos != '0' && *pos != '1');
+  }
+
+  /// Parse a (possibly signed) int argument starting at pos.
+  static bool ParseArg(const char *& pos, const char * end, int & val) {
+    bool neg = false;
+    if (pos < end && (*pos == '-' || *pos == '+')) neg = (*pos++ == '-');
+    if (pos == end || *pos < '0' || *pos > '9') return false;
+    int64_t total = 0;
+    for (; pos < end && *pos >= '0' && *pos <= '9'; ++pos) {
+      total = total * 10 + (*pos - '0');
+      if (total > (int64_t)INT_MAX + 1) return false;
+    }
+    if (neg) total = -total;
+    if (total > INT_MAX || total < INT_MIN) return false;
+    val = (int)total;
+    return true;
+  }
+
+  /// Parse lines [begin, end) (first_line is begin's line number in where) into program.
+  bool Parse(const char * begin, const char * end, const std::string & where, size_t first_line, program_t & program) {
+    program.Clear();
+    affinity_t tag;
+    size_t line = first_line;
+    for (const char * line_begin = begin; line_begin < end; ++line) {
+      const char * line_end = static_cast<const char *>(std::memchr(line_begin, '\n', (size_t)(end - line_begin)));
+      if (!line_end) line_end = end;
+      const char * next_line = line_end + (line_end < end);
+      // Strip comments and surrounding whitespace.
+      for (const char * c = line_begin; c < line_end; ++c) {
+        if (*c == '#' || (*c == '/' && c + 1 < line_end && c[1] == '/')) { line_end = c; break; }
+      }
+      const char * pos = line_begin;
+      while (pos < line_end && IsSpace(*pos)) ++pos;
+      while (line_end > pos && IsSpace(line_end[-1])) --line_end;
+      if (pos == line_end) { line_begin = next_line; continue; }
+      // Function: 'Fn-TAG:'
+      if (line_end - pos >= 3 && std::memcmp(pos, "Fn-", 3) == 0) {
+        pos += 3;
+        const char * tag_begin = pos;
+        if (!ParseTag(pos, line_end, tag)) {
+          return Fail(where, line, line_begin, tag_begin, "expected a " + std::to_string(affinity_t::GetSize()) + "-bit function tag");
+        }
+        if (pos < line_end && *pos == ':') ++pos;
+        if (pos != line_end) return Fail(where, line, line_begin, pos, "unexpected characters after function tag");
+        program.PushFunction(function_t(tag));
+        line_begin = next_line;
+        continue;
+      }
+      // Instruction: 'NAME', 'NAME(ARG,...)', and/or '[TAG]'
+      const char * name_begin = pos;
+      while (pos < line_end && *pos != '(' && *pos != '[' && !IsSpace(*pos)) ++pos;
+      const size_t id = GetID(name_begin, pos);
+      if (id == NO_INST) return Fail(where, line, line_begin, name_begin, "unknown instruction '" + std::string(name_begin, pos) + "'");
+      if (!program.GetSize()) return Fail(where, line, line_begin, name_begin, "instruction before first function ('Fn-' line)");
+      int args[MAX_ARGS] = {0, 0, 0};
+      tag = affinity_t();
+      while (pos < line_end && IsSpace(*pos)) ++pos;
+      if (pos < line_end && *pos == '(') {
+        ++pos;
+        while (pos < line_end && IsSpace(*pos)) ++pos;
+        for (size_t arg_cnt = 0; pos < line_end && *pos != ')'; ++arg_cnt) {
+          if (arg_cnt == MAX_ARGS) return Fail(where, line, line_begin, pos, "too many arguments (at most " + std::to_string(MAX_ARGS) + ")");
+          const char * arg_begin = pos;
+          if (!ParseArg(pos, line_end, args[arg_cnt])) return Fail(where, line, line_begin, arg_begin, "expected an integer argument");
+          while (pos < line_end && IsSpace(*pos)) ++pos;
+          if (pos < line_end && *pos == ',') {
+            ++pos;
+            while (pos < line_end && IsSpace(*pos)) ++pos;
+          } else if (pos < line_end && *pos != ')') {
+            return Fail(where, line, line_begin, pos, "expected ',' or ')'");
+          }
+        }
+        if (pos == line_end) return Fail(where, line, line_begin, pos, "missing ')'");
+        ++pos;
+        while (pos < line_end && IsSpace(*pos)) ++pos;
+      }
+      if (pos < line_end && *pos == '[') {
+        const char * tag_begin = ++pos;
+        if (!ParseTag(pos, line_end, tag)) {
+          return Fail(where, line, line_begin, tag_begin, "expected a " + std::to_string(affinity_t::GetSize()) + "-bit tag");
+        }
+        if (pos == line_end || *pos != ']') return Fail(where, line, line_begin, pos, "missing ']'");
+        ++pos;
+      }
+      if (pos != line_end) return Fail(where, line, line_begin, pos, "unexpected characters after instruction");
+      program.PushInst(id, args[0], args[1], args[2], tag);
+      line_begin = next_line;
+    }
+    return true;
+  }
+
+public:
+  ProgramLoader(emp::Ptr<const inst_lib_t> _inst_lib)
+    : inst_lib(_inst_lib), names(), ids(), seed(0), mask(0), error()
+  {
+    // Later instructions with a repeated name win (as with InstLib::GetID).
+    std::unordered_map<std::string, size_t> name_ids;
+    for (size_t id = 0; id < inst_lib->GetSize(); ++id) name_ids[inst_lib->GetName(id)] = id;
+    // Find a seed that hashes every name to its own slot (doubling the table if none turn up).
+    size_t table_size = 1;
+    while (table_size < 2 * name_ids.size()) table_size <<= 1;
+    for (bool found = false; !found; table_size <<= 1) {
+      mask = table_size - 1;
+      for (seed = 0; seed < 1024 && !found; ++seed) {
+        ids.assign(table_size, NO_INST);
+        found = true;
+        for (const auto & name_id : name_ids) {
+          const std::string & name = name_id.first;
+          size_t & slot = ids[Hash(name.data(), name.data() + name.size(), seed) & mask];
+          if (slot != NO_INST) { found = false; break; }
+          slot = name_id.second;
+        }
+      }
+      if (found) { --seed; break; }
+    }
+    names.assign(ids.size(), "");
+    for (size_t slot = 0; slot < ids.size(); ++slot) if (ids[slot] != NO_INST) names[slot] = inst_lib->GetName(ids[slot]);
+  }
+
+  /// Description of why the last load failed ('file:line:column: problem').
+  const std::string & GetError() const { return error; }
+
+  /// Instruction ID of name [begin, end) (NO_INST if library has no such instruction).
+  size_t GetID(const char * begin, const char * end) const {
+    const size_t slot = Hash(begin, end, seed) & mask;
+    const std::string & name = names[slot];
+    if (ids[slot] == NO_INST || name.size() != (size_t)(end - begin) || std::memcmp(name.data(), begin, name.size()) != 0) return NO_INST;
+    return ids[slot];
+  }
+
+  /// Load program text [begin, end) into program (which must already have this loader's instruction
+  /// library). where names the text in error messages.
+  bool Load(const char * begin, const char * end, program_t & program, const std::string & where="program") {
+    error.clear();
+    return Parse(begin, end, where, 1, program);
+  }
+
+  /// Load program file (.gp) at fpath into program.
+  bool LoadFile(const std::string & fpath, program_t & program) {
+    error.clear();
+    MappedFile file(fpath);
+    if (!file.IsOpen()) { error = fpath + ": could not open file"; return false; }
+    return Parse(file.GetData(), file.GetEnd(), fpath, 1, program);
+  }
+
+  /// Load every program in population snapshot (.pop) at fpath into programs. Programs are separated by
+  /// '===' lines; empty programs are skipped.
+  bool LoadPopFile(const std::string & fpath, emp::vector<program_t> & programs) {
+    error.clear();
+    programs.clear();
+    MappedFile file(fpath);
+    if (!file.IsOpen()) { error = fpath + ": could not open file"; return false; }
+    const char * end = file.GetEnd();
+    const char * prog_begin = file.GetData();
+    size_t prog_line = 1;   // Line number of prog_begin.
+    size_t line = 1;
+    bool prog_empty = true;
+    auto load_prog = [this, &programs, &fpath, &prog_begin, &prog_line, &prog_empty](const char * prog_end) {
+      if (prog_empty) return true;
+      programs.emplace_back(inst_lib);
+      return Parse(prog_begin, prog_end, fpath, prog_line, programs.back());
+    };
+    for (const char * line_begin = prog_begin; line_begin < end; ++line) {
+      const char * line_end = static_cast<const char *>(std::memchr(line_begin, '\n', (size_t)(end - line_begin)));
+      if (!line_end) line_end = end;
+      const char * next_line = line_end + (line_end < end);
+      const char * pos = line_begin;
+      while (pos < line_end && IsSpace(*pos)) ++pos;
+      const char * trimmed_end = line_end;
+      while (trimmed_end > pos && IsSpace(trimmed_end[-1])) --trimmed_end;
+      if (trimmed_end - pos == 3 && std::memcmp(pos, "===", 3) == 0) {
+        if (!load_prog(line_begin)) return false;
+        prog_begin = next_line;
+        prog_line = line + 1;
+        prog_empty = true;
+      } else if (pos < trimmed_end) {
+        prog_empty = false;
+      }
+      line_begin = next_line;
+    }
+    return load_prog(end);
+  }
+};
+
+// (Definitions for ODR-uses, e.g., ids.assign(table_size, NO_INST); required before C++17.)
+template <typename HARDWARE> constexpr size_t ProgramLoader<HARDWARE>::NO_INST;
+template <typename HARDWARE> constexpr size_t ProgramLoader<HARDWARE>::MAX_ARGS;
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SHARED_PROGRAM_H
+#define SHARED_PROGRAM_H
+
+#include <memory>
+#include "base/Ptr.h"
+
+#include "InstDispatchTable.h"
+#include "DecodedProgram.h"
+
+/// Immutable SignalGP program plus everything derived from it, meant to be shared (via
+/// std::shared_ptr<const SharedProgram>) by any number of hardware units (see FastEventDrivenGP.h).
+/// - decoded: the program decoded against a dispatch table (if one was given).
+/// - skeleton: the program's functions with their tags but without instructions. Hardware running the
+///   decoded program only needs its own copy of the skeleton (for tag-based function lookups), rather
+///   than a full copy of the program.
+/// Make a new SharedProgram (rather than changing one) whenever the program changes.
+template <typename HARDWARE>
+class SharedProgram {
+public:
+  using hardware_t = HARDWARE;
+  using program_t = typename hardware_t::program_t;
+  using function_t = typename hardware_t::Function;
+  using dispatch_table_t = InstDispatchTable<hardware_t>;
+  using decoded_program_t = DecodedProgram<hardware_t>;
+
+protected:
+  program_t program;
+  program_t skeleton;
+  decoded_program_t decoded;
+  emp::Ptr<const dispatch_table_t> dispatch_table;   ///< Table program was decoded against.
+
+public:
+  SharedProgram(const program_t & _program, emp::Ptr<const dispatch_table_t> _table=nullptr)
+    : program(_program), skeleton(_program.GetInstLib()), decoded(), dispatch_table(nullptr)
+  {
+    for (size_t fp = 0; fp < program.GetSize(); ++fp) skeleton.PushFunction(function_t(program[fp].GetAffinity()));
+    if (_table && decoded.Decode(program, *_table)) dispatch_table = _table;
+  }
+
+  /// Program that differs from base's only in instruction ip of function fp (e.g., a knockout). Reuses
+  /// base's skeleton and decoded program, patching the one instruction where block structure allows.
+  SharedProgram(const SharedProgram & base, const program_t & _program, size_t fp, size_t ip)
+    : program(_program), skeleton(base.skeleton), decoded(base.decoded), dispatch_table(base.dispatch_table)
+  {
+    if (dispatch_table && !decoded.Patch(program, fp, ip, *dispatch_table) && !decoded.Decode(program, *dispatch_table)) {
+      dispatch_table = nullptr;
+    }
+  }
+
+  SharedProgram(const SharedProgram &) = delete;
+  SharedProgram & operator=(const SharedProgram &) = delete;
+
+  const program_t & GetProgram() const { return program; }
+  const program_t & GetSkeleton() const { return skeleton; }
+  const decoded_program_t & GetDecoded() const { return decoded; }
+  size_t GetMemoryBytes() const {
+    return memory_usage::ProgramBytes(program) + memory_usage::ProgramBytes(skeleton) + decoded.GetMemoryBytes();
+  }
+
+  /// Was this program successfully decoded against given dispatch table?
+  bool IsDecodedFor(emp::Ptr<const dispatch_table_t> table) const { return table && dispatch_table == table; }
+};
+
+#endif
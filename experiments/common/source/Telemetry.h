@@ -0,0 +1,153 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "base/vector.h"
+
+/// Live run telemetry: a POSIX shared memory page holding a run's current stats (named values), for
+/// external monitors to poll (e.g., native/telemetry.cc) while the run goes on.
+/// - The run adds its stats (AddStat; each a name and a function that gets its current value), then
+///   creates the page (Open, which removes any stale page left by a killed run) and calls Publish
+///   whenever it likes (e.g., once per generation). Close removes the page.
+/// - Publish is a seqlock write: the run never waits on readers (publication is wait-free), and readers
+///   (Read) retry if they catch a publication in progress.
+class TelemetryPage {
+public:
+  static constexpr size_t MAX_STATS = 64;
+  static constexpr size_t NAME_BYTES = 48;
+
+protected:
+  static constexpr uint64_t MAGIC = 0x53475054454C454Dull;  // "SGPTELEM"
+
+  struct Page {
+    std::atomic<uint64_t> magic;            ///< Set (last) once the page is initialized.
+    std::atomic<uint64_t> seq;              ///< Publication sequence number; odd while publishing.
+    uint64_t pid;                           ///< Process publishing to the page.
+    uint64_t stat_cnt;
+    char names[MAX_STATS][NAME_BYTES];
+    std::atomic<uint64_t> values[MAX_STATS];  ///< (Bits of double values.)
+  };
+
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared memory telemetry needs lock-free 64-bit atomics.");
+
+  std::string name;
+  emp::vector<std::string> stat_names;
+  emp::vector<std::function<double(void)>> stat_funs;
+  int fd;
+  Page * page;
+
+  static uint64_t ToBits(double value) { uint64_t bits; std::memcpy(&bits, &value, sizeof(bits)); return bits; }
+  static double FromBits(uint64_t bits) { double value; std::memcpy(&value, &bits, sizeof(value)); return value; }
+  static std::string FixName(const std::string & name) { return (name.empty() || name[0] != '/') ? "/" + name : name; }
+
+public:
+  TelemetryPage(const std::string & _name)
+    : name(FixName(_name)), stat_names(), stat_funs(), fd(-1), page(nullptr) { ; }
+
+  ~TelemetryPage() { Close(); }
+
+  TelemetryPage(const TelemetryPage &) = delete;
+  TelemetryPage & operator=(const TelemetryPage &) = delete;
+
+  bool IsOpen() const { return page != nullptr; }
+  size_t GetStatCnt() const { return stat_names.size(); }
+
+  /// Add stat (before Open); names longer than NAME_BYTES-1 are cut short. Returns false if the page
+  /// is already open or full.
+  bool AddStat(const std::string & stat_name, const std::function<double(void)> & get_value) {
+    if (IsOpen() || stat_names.size() == MAX_STATS) return false;
+    stat_names.emplace_back(stat_name.substr(0, NAME_BYTES - 1));
+    stat_funs.emplace_back(get_value);
+    return true;
+  }
+
+  /// Create the page (with every stat at 0).
+  bool Open(std::ostream & err=std::cerr) {
+    if (IsOpen()) return true;
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) { err << "TelemetryPage: failed to create " << name << std::endl; return false; }
+    if (ftruncate(fd, (off_t)sizeof(Page)) != 0) { err << "TelemetryPage: failed to size " << name << std::endl; Close(); return false; }
+    void * ptr = mmap(nullptr, sizeof(Page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) { err << "TelemetryPage: failed to map " << name << std::endl; Close(); return false; }
+    std::memset(ptr, 0, sizeof(Page));
+    page = new (ptr) Page();
+    page->seq.store(0);
+    page->pid = (uint64_t)getpid();
+    page->stat_cnt = stat_names.size();
+    for (size_t i = 0; i < stat_names.size(); ++i) {
+      std::memcpy(page->names[i], stat_names[i].data(), stat_names[i].size());
+      page->values[i].store(ToBits(0.0));
+    }
+    page->magic.store(MAGIC, std::memory_order_release);
+    return true;
+  }
+
+  /// Remove the page (monitors that already have it mapped keep their last view of it).
+  void Close() {
+    if (page) munmap(page, sizeof(Page));
+    if (fd >= 0) {
+      close(fd);
+      shm_unlink(name.c_str());
+    }
+    page = nullptr;
+    fd = -1;
+  }
+
+  /// Publish every stat's current value.
+  void Publish() {
+    if (!IsOpen()) return;
+    const uint64_t seq = page->seq.load(std::memory_order_relaxed);
+    page->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < stat_funs.size(); ++i) page->values[i].store(ToBits(stat_funs[i]()), std::memory_order_relaxed);
+    page->seq.store(seq + 2, std::memory_order_release);
+  }
+
+  /// Monitors: read a consistent view of page shm_name (stat names and values, the publishing process,
+  /// and the number of publications so far). Fails if there is no such page or it stays mid-publication
+  /// for max_tries tries.
+  static bool Read(const std::string & shm_name, emp::vector<std::string> & names, emp::vector<double> & values,
+                   uint64_t & pid, uint64_t & publish_cnt, size_t max_tries=100000) {
+    const std::string fixed_name = FixName(shm_name);
+    const int read_fd = shm_open(fixed_name.c_str(), O_RDONLY, 0);
+    if (read_fd < 0) return false;
+    struct stat info;
+    if (fstat(read_fd, &info) != 0 || (size_t)info.st_size < sizeof(Page)) { close(read_fd); return false; }
+    void * ptr = mmap(nullptr, sizeof(Page), PROT_READ, MAP_SHARED, read_fd, 0);
+    close(read_fd);
+    if (ptr == MAP_FAILED) return false;
+    const Page & read_page = *static_cast<const Page *>(ptr);
+    bool ok = false;
+    if (read_page.magic.load(std::memory_order_acquire) == MAGIC && read_page.stat_cnt <= MAX_STATS) {
+      const size_t stat_cnt = read_page.stat_cnt;
+      names.resize(stat_cnt);
+      values.resize(stat_cnt);
+      for (size_t i = 0; i < stat_cnt; ++i) names[i].assign(read_page.names[i], strnlen(read_page.names[i], NAME_BYTES));
+      pid = read_page.pid;
+      for (size_t tries = 0; tries < max_tries && !ok; ++tries) {
+        const uint64_t seq = read_page.seq.load(std::memory_order_acquire);
+        if (seq & 1) { std::this_thread::yield(); continue; }
+        for (size_t i = 0; i < stat_cnt; ++i) values[i] = FromBits(read_page.values[i].load(std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        ok = read_page.seq.load(std::memory_order_relaxed) == seq;
+        publish_cnt = seq / 2;
+      }
+    }
+    munmap(ptr, sizeof(Page));
+    return ok;
+  }
+};
+
+#endif
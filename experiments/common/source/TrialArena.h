@@ -0,0 +1,300 @@
+#ifndef TRIAL_ARENA_H
+#define TRIAL_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#ifdef SGP_HW_ARENA
+#include <sys/mman.h>
+#endif
+
+/// Per-hardware allocation arena for SignalGP run-time state (build with -DSGP_HW_ARENA; make arena).
+///
+/// EventDrivenGP's call states, memory maps, and queued events use the standard allocator, so the arena is
+/// reached through the replacement operator new/delete in AllocCounter.h: while an arena is current on a
+/// thread (see Scope), that thread's allocations are drawn from it. FastEventDrivenGP makes its arena current
+/// while it runs, resets, spawns cores, and queues events. Every block records its arena, so it can be freed
+/// from anywhere (e.g., a message one hardware unit queued on another).
+/// - Small blocks (memory map nodes and buckets, block stacks, short call stacks: up to SMALL_MAX bytes) are
+///   bump allocated from the bottom and recycled through per-size free lists during a trial. Reset drops them
+///   all in one step (rewinds the bump pointer and empties the free lists) at trial end, once the hardware has
+///   released its run-time state. If small blocks are still held elsewhere (e.g., messages waiting in an
+///   experiment's inbox), the reset is skipped (see GetSkippedResetCnt) and the free lists keep recycling.
+/// - Large blocks (long call stacks, event queue chunks, posted-message buffers: up to LARGE_MAX bytes) are
+///   taken from the top and kept across resets (containers hold on to them between trials); they are recycled
+///   through power-of-two free lists.
+/// - Capacity is fixed when the arena is made (hardware asks for max cores x max call depth x CALL_STATE_BYTES).
+///   Requests that do not fit, or are larger than LARGE_MAX, go to malloc (and are counted by make count-allocs).
+/// Arenas are carved out of one address range reserved up front (pages are only backed once touched), so
+/// operator delete tells arena blocks from malloc blocks with a range check.
+/// Without SGP_HW_ARENA, TrialArena is an empty stand-in: Make returns nullptr and scopes do nothing.
+
+#ifdef SGP_HW_ARENA
+constexpr bool TRIAL_ARENA_ENABLED = true;
+
+class TrialArena {
+public:
+  static constexpr size_t CALL_STATE_BYTES = 4096;  ///< Arena bytes per call state (its memory maps and block stack, plus its share of queued events).
+  static constexpr size_t ALIGN = 16;
+  static constexpr size_t SMALL_MAX = 256;
+  static constexpr size_t LARGE_MIN = 512;
+  static constexpr size_t LARGE_MAX = (size_t)1 << 20;
+  static constexpr size_t SMALL_CLASS_CNT = SMALL_MAX / ALIGN;
+  static constexpr size_t LARGE_CLASS_CNT = 12;       ///< LARGE_MIN, 2*LARGE_MIN, ..., LARGE_MAX.
+
+  /// Make arena current on this thread for the scope's lifetime (nullptr: leave the current arena as is).
+  class Scope {
+    TrialArena * prev;
+    bool active;
+  public:
+    explicit Scope(TrialArena * arena) : prev(Current()), active(arena != nullptr) { if (active) Current() = arena; }
+    Scope(Scope && in) : prev(in.prev), active(in.active) { in.active = false; }
+    Scope(const Scope &) = delete;
+    Scope & operator=(const Scope &) = delete;
+    ~Scope() { if (active) Current() = prev; }
+  };
+
+  /// No arena is current for the pause's lifetime (for allocations that must outlive a trial).
+  class Pause {
+    TrialArena * prev;
+  public:
+    Pause() : prev(Current()) { Current() = nullptr; }
+    Pause(const Pause &) = delete;
+    Pause & operator=(const Pause &) = delete;
+    ~Pause() { Current() = prev; }
+  };
+
+protected:
+  struct Header { TrialArena * owner; size_t cls; };
+  struct FreeBlock { FreeBlock * next; };
+
+  /// Address range all arenas are carved from; arenas' slices are reused once released.
+  struct Region {
+    static constexpr size_t BYTES = (size_t)1 << 40;
+    static constexpr size_t MAX_FREE_SLICES = 1024;
+    std::atomic<char *> begin;
+    std::mutex mutex;
+    size_t used;
+    size_t free_cnt;
+    char * free_slices[MAX_FREE_SLICES];
+    size_t free_slice_bytes[MAX_FREE_SLICES];
+  };
+
+  static Region & GetRegion() { static Region region{}; return region; }
+  static TrialArena *& Current() { static thread_local TrialArena * current = nullptr; return current; }
+
+  char * small_begin;
+  char * small_top;       ///< Small blocks: [small_begin, small_top).
+  char * large_bottom;    ///< Large blocks: [large_bottom, end).
+  char * end;
+  size_t slice_bytes;
+  FreeBlock * free_lists[SMALL_CLASS_CNT + LARGE_CLASS_CNT];
+  size_t small_live;
+  size_t large_live;
+  size_t reset_cnt;
+  size_t skipped_reset_cnt;
+  size_t overflow_cnt;
+  bool orphaned;          ///< Owner is gone; slice is released when the last block comes back.
+  std::atomic<bool> locked;
+
+  TrialArena(char * slice, size_t bytes)
+    : small_begin(slice + ((sizeof(TrialArena) + ALIGN - 1) / ALIGN) * ALIGN), small_top(small_begin),
+      large_bottom(slice + bytes), end(slice + bytes), slice_bytes(bytes), free_lists(),
+      small_live(0), large_live(0), reset_cnt(0), skipped_reset_cnt(0), overflow_cnt(0), orphaned(false), locked(false) { ; }
+
+  void Lock() { while (locked.exchange(true, std::memory_order_acquire)) { ; } }
+  void Unlock() { locked.store(false, std::memory_order_release); }
+
+  static void ReleaseSlice(TrialArena * arena) {
+    char * slice = (char *)arena;
+    const size_t bytes = arena->slice_bytes;
+    arena->~TrialArena();
+    Region & region = GetRegion();
+    std::lock_guard<std::mutex> lock(region.mutex);
+    mmap(slice, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    if (region.free_cnt < Region::MAX_FREE_SLICES) {
+      region.free_slices[region.free_cnt] = slice;
+      region.free_slice_bytes[region.free_cnt] = bytes;
+      ++region.free_cnt;
+    }
+  }
+
+  void Free(Header * header) {
+    const size_t cls = header->cls;
+    Lock();
+    FreeBlock * block = (FreeBlock *)header;
+    block->next = free_lists[cls];
+    free_lists[cls] = block;
+    if (cls < SMALL_CLASS_CNT) --small_live;
+    else --large_live;
+    const bool release = orphaned && !small_live && !large_live;
+    Unlock();
+    if (release) ReleaseSlice(this);
+  }
+
+public:
+  /// Make an arena with room for (about) given number of bytes; nullptr if address space is not available.
+  static TrialArena * Make(size_t bytes) {
+    const size_t page = 4096;
+    bytes = ((bytes + sizeof(TrialArena) + page - 1) / page) * page;
+    Region & region = GetRegion();
+    std::lock_guard<std::mutex> lock(region.mutex);
+    char * begin = region.begin.load(std::memory_order_relaxed);
+    if (!begin) {
+      void * ptr = mmap(nullptr, Region::BYTES, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (ptr == MAP_FAILED) return nullptr;
+      begin = (char *)ptr;
+      region.begin.store(begin, std::memory_order_release);
+    }
+    char * slice = nullptr;
+    for (size_t i = 0; i < region.free_cnt; ++i) {
+      if (region.free_slice_bytes[i] < bytes) continue;
+      slice = region.free_slices[i];
+      bytes = region.free_slice_bytes[i];
+      --region.free_cnt;
+      region.free_slices[i] = region.free_slices[region.free_cnt];
+      region.free_slice_bytes[i] = region.free_slice_bytes[region.free_cnt];
+      break;
+    }
+    if (!slice) {
+      if (Region::BYTES - region.used < bytes) return nullptr;
+      slice = begin + region.used;
+      region.used += bytes;
+    }
+    if (mprotect(slice, bytes, PROT_READ | PROT_WRITE) != 0) return nullptr;
+    return new (slice) TrialArena(slice, bytes);
+  }
+
+  TrialArena(const TrialArena &) = delete;
+  TrialArena & operator=(const TrialArena &) = delete;
+
+  /// Block of at least size bytes (16-byte aligned); nullptr if it does not fit.
+  void * Allocate(size_t size) {
+    if (size > LARGE_MAX) return nullptr;
+    size_t cls = 0;
+    size_t block_bytes = sizeof(Header);
+    if (size <= SMALL_MAX) {
+      cls = (size ? size - 1 : 0) / ALIGN;
+      block_bytes += (cls + 1) * ALIGN;
+    } else {
+      size_t bytes = LARGE_MIN;
+      cls = SMALL_CLASS_CNT;
+      while (bytes < size) { bytes <<= 1; ++cls; }
+      block_bytes += bytes;
+    }
+    Lock();
+    char * block = (char *)free_lists[cls];
+    if (block) {
+      free_lists[cls] = free_lists[cls]->next;
+    } else if ((size_t)(large_bottom - small_top) < block_bytes) {
+      ++overflow_cnt;
+      Unlock();
+      return nullptr;
+    } else if (cls < SMALL_CLASS_CNT) {
+      block = small_top;
+      small_top += block_bytes;
+    } else {
+      large_bottom -= block_bytes;
+      block = large_bottom;
+    }
+    if (cls < SMALL_CLASS_CNT) ++small_live;
+    else ++large_live;
+    Unlock();
+    Header * header = (Header *)block;
+    header->owner = this;
+    header->cls = cls;
+    return block + sizeof(Header);
+  }
+
+  /// Drop all small blocks in one step (only if none are still held); returns whether it did.
+  bool Reset() {
+    Lock();
+    const bool reset = !small_live;
+    if (reset) {
+      small_top = small_begin;
+      for (size_t cls = 0; cls < SMALL_CLASS_CNT; ++cls) free_lists[cls] = nullptr;
+      ++reset_cnt;
+    } else {
+      ++skipped_reset_cnt;
+    }
+    Unlock();
+    return reset;
+  }
+
+  /// Give up the arena (owner is done with it); it goes away once all of its blocks have been freed.
+  void Release() {
+    Lock();
+    orphaned = true;
+    const bool release = !small_live && !large_live;
+    Unlock();
+    if (release) ReleaseSlice(this);
+  }
+
+  /// Is ptr (the start of an allocation) a small block from this arena?
+  bool OwnsSmall(const void * ptr) const {
+    if (!IsArenaPtr(ptr)) return false;
+    const Header * header = (const Header *)((const char *)ptr - sizeof(Header));
+    return header->owner == this && header->cls < SMALL_CLASS_CNT;
+  }
+
+  size_t GetCapacity() const { return (size_t)(end - small_begin); }
+  size_t GetUsedBytes() const { return (size_t)(small_top - small_begin) + (size_t)(end - large_bottom); }
+  size_t GetResetCnt() const { return reset_cnt; }
+  size_t GetSkippedResetCnt() const { return skipped_reset_cnt; }
+  size_t GetOverflowCnt() const { return overflow_cnt; }
+
+  static bool IsArenaPtr(const void * ptr) {
+    const char * begin = GetRegion().begin.load(std::memory_order_acquire);
+    return begin && (const char *)ptr >= begin && (const char *)ptr < begin + Region::BYTES;
+  }
+
+  /// Allocate from this thread's current arena, if any (nullptr: use malloc).
+  static void * AllocateCurrent(size_t size) {
+    TrialArena * arena = Current();
+    return arena ? arena->Allocate(size) : nullptr;
+  }
+
+  /// Free ptr if it came from an arena (any thread's); returns false for malloc blocks.
+  static bool DeallocateIfOwned(void * ptr) {
+    if (!IsArenaPtr(ptr)) return false;
+    Header * header = (Header *)((char *)ptr - sizeof(Header));
+    header->owner->Free(header);
+    return true;
+  }
+};
+
+#else
+constexpr bool TRIAL_ARENA_ENABLED = false;
+
+class TrialArena {
+public:
+  static constexpr size_t CALL_STATE_BYTES = 4096;
+
+  class Scope {
+  public:
+    explicit Scope(TrialArena *) { ; }
+    ~Scope() { ; }
+  };
+
+  class Pause {
+  public:
+    Pause() { ; }
+    ~Pause() { ; }
+  };
+
+  static TrialArena * Make(size_t) { return nullptr; }
+  bool Reset() { return false; }
+  void Release() { ; }
+  bool OwnsSmall(const void *) const { return false; }
+  size_t GetCapacity() const { return 0; }
+  size_t GetUsedBytes() const { return 0; }
+  size_t GetResetCnt() const { return 0; }
+  size_t GetSkippedResetCnt() const { return 0; }
+  size_t GetOverflowCnt() const { return 0; }
+  static void * AllocateCurrent(size_t) { return nullptr; }
+  static bool DeallocateIfOwned(void *) { return false; }
+};
+#endif
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "base/vector.h"
+
+/// Minimal fixed-size pool of worker threads for running a batch of independent jobs and waiting
+/// for all of them to finish (i.e., fork-join). Used to advance deme tiles and evaluate analysis trials in parallel.
+/// - The calling thread participates in every batch, so a pool of size N spawns N-1 threads.
+/// - A pool of size 1 (or 0) runs everything on the calling thread.
+class WorkerPool {
+public:
+  using job_fun_t = std::function<void(size_t)>;
+
+protected:
+  emp::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+
+  const job_fun_t * job;      ///< Job for current batch (only valid during Run).
+  size_t job_cnt;             ///< Number of jobs in current batch.
+  std::atomic<size_t> next_job;
+  size_t busy_workers;        ///< Workers that have not yet finished current batch.
+  size_t batch_id;            ///< Incremented every batch; wakes workers.
+  bool stop;
+
+  void DoJobs() {
+    for (size_t i = next_job.fetch_add(1); i < job_cnt; i = next_job.fetch_add(1)) (*job)(i);
+  }
+
+  void WorkerLoop() {
+    size_t seen_batch = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        start_cv.wait(lock, [this, seen_batch]() { return stop || batch_id != seen_batch; });
+        if (stop) return;
+        seen_batch = batch_id;
+      }
+      DoJobs();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy_workers == 0) done_cv.notify_one();
+      }
+    }
+  }
+
+public:
+  WorkerPool(size_t num_threads)
+    : threads(), job(nullptr), job_cnt(0), next_job(0), busy_workers(0), batch_id(0), stop(false)
+  {
+    for (size_t i = 1; i < num_threads; ++i) threads.emplace_back([this]() { this->WorkerLoop(); });
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    start_cv.notify_all();
+    for (std::thread & t : threads) t.join();
+  }
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool & operator=(const WorkerPool &) = delete;
+
+  /// How many threads (including the calling thread) work on each batch?
+  size_t GetSize() const { return threads.size() + 1; }
+
+  /// Run fun(0) ... fun(cnt-1), distributing calls over the pool. Blocks until all calls return.
+  void Run(size_t cnt, const job_fun_t & fun) {
+    if (threads.empty() || cnt <= 1) {
+      for (size_t i = 0; i < cnt; ++i) fun(i);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      job = &fun;
+      job_cnt = cnt;
+      next_job = 0;
+      busy_workers = threads.size();
+      ++batch_id;
+    }
+    start_cv.notify_all();
+    DoJobs();
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this]() { return busy_workers == 0; });
+    job = nullptr;
+  }
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef WORLD_DATA_FILES_H
+#define WORLD_DATA_FILES_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include "base/Ptr.h"
+#include "base/vector.h"
+
+#include "ColumnarFile.h"
+
+/// Add the world's systematics file columns (other than update) to file (an emp::DataFile or a
+/// ColumnarFile), reading them from sys (the world's systematics manager or CompactSystematics).
+template <typename DATA_FILE, typename SYSTEMATICS>
+DATA_FILE & AddSystematicsColumns(DATA_FILE & file, SYSTEMATICS & sys) {
+  std::function<size_t(void)> get_num_taxa = [&sys]() { return (size_t)sys.GetNumActive(); };
+  file.AddFun(get_num_taxa, "num_taxa", "Number of unique taxonomic groups currently active.");
+  std::function<size_t(void)> get_total_orgs = [&sys]() { return (size_t)sys.GetTotalOrgs(); };
+  file.AddFun(get_total_orgs, "total_orgs", "Number of organisms tracked.");
+  std::function<double(void)> get_ave_depth = [&sys]() { return (double)sys.GetAveDepth(); };
+  file.AddFun(get_ave_depth, "ave_depth", "Average Phylogenetic Depth of Organisms.");
+  std::function<size_t(void)> get_num_roots = [&sys]() { return (size_t)sys.GetNumRoots(); };
+  file.AddFun(get_num_roots, "num_roots", "Number of independent roots for phylogenies.");
+  std::function<int(void)> get_mrca_depth = [&sys]() { return (int)sys.GetMRCADepth(); };
+  file.AddFun(get_mrca_depth, "mrca_depth", "Phylogenetic Depth of the Most Recent Common Ancestor (-1=none).");
+  std::function<double(void)> get_diversity = [&sys]() { return (double)sys.CalcDiversity(); };
+  file.AddFun(get_diversity, "diversity", "Genotypic Diversity (entropy of taxa in population).");
+  return file;
+}
+
+/// Binary columnar (see ColumnarFile.h) stand-ins for an emp::World's data files. All files are updated
+/// together by Update, which should be called right before each world update (the same point at which the
+/// world updates its own data files).
+template <typename WORLD>
+class WorldColumnarFiles {
+public:
+  using world_t = WORLD;
+
+protected:
+  struct FitnessSummary { double mean; double min; double max; };
+
+  emp::vector<emp::Ptr<ColumnarFile>> files;
+  emp::vector<std::string> fpaths;
+  FitnessSummary fit_summary;   ///< Population fitness (for fitness files); computed by Update.
+  bool track_fitness;           ///< Is there a fitness file?
+
+public:
+  WorldColumnarFiles() : files(), fpaths(), fit_summary{0, 0, 0}, track_fitness(false) { ; }
+  ~WorldColumnarFiles() { Clear(); }
+
+  WorldColumnarFiles(const WorldColumnarFiles &) = delete;
+  WorldColumnarFiles & operator=(const WorldColumnarFiles &) = delete;
+
+  /// Are all files open? If not, says which one failed on err.
+  bool IsGood(std::ostream & err=std::cerr) const {
+    for (size_t i = 0; i < files.size(); ++i) {
+      if (files[i]->IsGood()) continue;
+      err << "Failed to open columnar data file (" << fpaths[i] << ")." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  /// Add a file (with no columns).
+  ColumnarFile & Add(const std::string & fpath) {
+    files.emplace_back(emp::NewPtr<ColumnarFile>(fpath));
+    fpaths.emplace_back(fpath);
+    return *files.back();
+  }
+
+  /// Add a file with the columns of the world's fitness file.
+  ColumnarFile & AddFitnessFile(world_t & world, const std::string & fpath) {
+    auto & file = Add(fpath);
+    track_fitness = true;
+    std::function<size_t(void)> get_update = [&world]() { return world.GetUpdate(); };
+    file.AddFun(get_update, "update", "Update");
+    std::function<double(void)> get_mean_fitness = [this]() { return fit_summary.mean; };
+    file.AddFun(get_mean_fitness, "mean_fitness", "Average organism fitness in current population.");
+    std::function<double(void)> get_min_fitness = [this]() { return fit_summary.min; };
+    file.AddFun(get_min_fitness, "min_fitness", "Minimum organism fitness in current population.");
+    std::function<double(void)> get_max_fitness = [this]() { return fit_summary.max; };
+    file.AddFun(get_max_fitness, "max_fitness", "Maximum organism fitness in current population.");
+    std::function<double(void)> get_inferiority = [this]() { return (fit_summary.max - fit_summary.mean) / fit_summary.max; };
+    file.AddFun(get_inferiority, "inferiority", "Average fitness / maximum fitness in current population.");
+    return file;
+  }
+
+  /// Add a file with the columns of the world's systematics file (read from the world's systematics manager).
+  ColumnarFile & AddSystematicsFile(world_t & world, const std::string & fpath) {
+    auto & file = Add(fpath);
+    std::function<size_t(void)> get_update = [&world]() { return world.GetUpdate(); };
+    file.AddFun(get_update, "update", "Update");
+    return AddSystematicsColumns(file, world.GetSystematics());
+  }
+
+  /// Update all files (if there are any).
+  void Update(world_t & world) {
+    if (files.empty()) return;
+    if (track_fitness) {
+      // Summarize population fitness.
+      fit_summary.mean = 0;
+      for (size_t id = 0; id < world.GetSize(); ++id) {
+        const double fitness = world.CalcFitnessID(id);
+        fit_summary.mean += fitness;
+        if (id == 0 || fitness < fit_summary.min) fit_summary.min = fitness;
+        if (id == 0 || fitness > fit_summary.max) fit_summary.max = fitness;
+      }
+      if (world.GetSize()) fit_summary.mean /= (double)world.GetSize();
+    }
+    for (auto file : files) file->Update(world.GetUpdate());
+  }
+
+  /// Flush and close all files.
+  void Clear() {
+    for (auto file : files) file.Delete();
+    files.clear();
+    fpaths.clear();
+    track_fitness = false;
+  }
+};
+
+#endif
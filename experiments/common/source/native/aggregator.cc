@@ -0,0 +1,214 @@
+// Native run data aggregator: aggregates final fitness information from every run directory of an
+// experiment (runs are processed in parallel) into the final fitness schema below. It does not write the
+// outputs of the scripts/aggregator.py scripts (e.g., mt_final_fitness.csv, consensus_fot.csv), which
+// remain the tools for those.
+//
+// usage: aggregator data_directory benchmark [options]
+//   -u UPDATE     Update to get fitness for (default: last complete line of each fitness file).
+//   -f FILE       Fitness file, relative to each run directory (default: output/fitness.csv).
+//   -m MATCH      Only aggregate run directories whose names contain MATCH (e.g., TSK0 or _DELAY).
+//   -t THREADS    Number of threads (default: one per hardware thread).
+//   -o DIR        Where to dump aggregated data (default: ./aggregated_data).
+//   -d UPDATE     Also write each run's final dominant (first program in output/pop_UPDATE/pop_UPDATE.pop)
+//                 to fdom.gp in its run directory (like getFDom.py).
+//
+// Writes DIR/benchmark/final_fitness.csv (or fitness_UPDATE.csv if -u is given) with columns
+//   benchmark, treatment, run_id, final_update, mean_fitness, max_fitness
+// Run directories are named treatment_runid. Lines that are cut short (e.g., files from killed runs) are
+// skipped: a line only counts if it ends in a newline and has a value for every header column.
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "../MappedFile.h"
+
+using field_t = std::pair<const char *, const char *>;
+
+struct RunResult {
+  std::string run;
+  bool valid = false;
+  std::string update;
+  std::string mean_fitness;
+  std::string max_fitness;
+  std::string message;   ///< Why run was skipped (or other warnings).
+};
+
+static field_t Trim(const char * begin, const char * end) {
+  while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\r')) ++begin;
+  while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+  return {begin, end};
+}
+
+/// Split line [begin, end) on commas into (trimmed) fields.
+static void SplitFields(const char * begin, const char * end, std::vector<field_t> & fields) {
+  fields.clear();
+  while (true) {
+    const char * comma = static_cast<const char *>(std::memchr(begin, ',', (size_t)(end - begin)));
+    if (!comma) { fields.emplace_back(Trim(begin, end)); return; }
+    fields.emplace_back(Trim(begin, comma));
+    begin = comma + 1;
+  }
+}
+
+static std::string ToString(const field_t & field) { return std::string(field.first, field.second); }
+
+/// Is line complete (has a value for each of the col_cnt columns)?
+static bool IsComplete(const std::vector<field_t> & fields, size_t col_cnt) {
+  if (fields.size() != col_cnt) return false;
+  for (const field_t & field : fields) if (field.first == field.second) return false;
+  return true;
+}
+
+static void AggregateRun(const std::string & data_dir, const std::string & fit_fname, const std::string & update,
+                         RunResult & result) {
+  const std::string fpath = data_dir + "/" + result.run + "/" + fit_fname;
+  MappedFile file(fpath);
+  if (!file.IsOpen()) { result.message = "Could not open " + fpath; return; }
+  const char * begin = file.GetData();
+  const char * end = file.GetEnd();
+  // Header (must be complete).
+  const char * header_end = begin ? static_cast<const char *>(std::memchr(begin, '\n', file.GetSize())) : nullptr;
+  if (!header_end) { result.message = "Missing header in " + fpath; return; }
+  std::vector<field_t> fields;
+  SplitFields(begin, header_end, fields);
+  const size_t col_cnt = fields.size();
+  size_t update_col = col_cnt, mean_col = col_cnt, max_col = col_cnt;
+  for (size_t i = 0; i < col_cnt; ++i) {
+    const std::string name = ToString(fields[i]);
+    if (name == "update") update_col = i;
+    else if (name == "mean_fitness") mean_col = i;
+    else if (name == "max_fitness") max_col = i;
+  }
+  if (update_col == col_cnt || mean_col == col_cnt || max_col == col_cnt) {
+    result.message = "Missing update/mean_fitness/max_fitness column in " + fpath;
+    return;
+  }
+  auto take = [&result, &fields, update_col, mean_col, max_col]() {
+    result.valid = true;
+    result.update = ToString(fields[update_col]);
+    result.mean_fitness = ToString(fields[mean_col]);
+    result.max_fitness = ToString(fields[max_col]);
+  };
+  const char * body = header_end + 1;
+  if (update.empty()) {
+    // Last complete line: walk backwards from the last newline (anything after it was cut short).
+    const char * line_end = end;
+    while (line_end > body && line_end[-1] != '\n') --line_end;
+    while (line_end > body) {
+      const char * line_begin = line_end - 1;
+      while (line_begin > body && line_begin[-1] != '\n') --line_begin;
+      SplitFields(line_begin, line_end - 1, fields);
+      if (IsComplete(fields, col_cnt)) { take(); return; }
+      line_end = line_begin;
+    }
+    result.message = "No complete lines in " + fpath;
+  } else {
+    for (const char * line_begin = body; line_begin < end; ) {
+      const char * line_end = static_cast<const char *>(std::memchr(line_begin, '\n', (size_t)(end - line_begin)));
+      if (!line_end) break;  // Cut short.
+      SplitFields(line_begin, line_end, fields);
+      if (IsComplete(fields, col_cnt) && ToString(fields[update_col]) == update) { take(); return; }
+      line_begin = line_end + 1;
+    }
+    result.message = "Update " + update + " not found in " + fpath;
+  }
+}
+
+/// Write first program of run's final population snapshot to run_dir/fdom.gp.
+static void ExtractFDom(const std::string & data_dir, const std::string & pop_update, RunResult & result) {
+  const std::string run_dir = data_dir + "/" + result.run;
+  const std::string pop_fpath = run_dir + "/output/pop_" + pop_update + "/pop_" + pop_update + ".pop";
+  MappedFile pop_file(pop_fpath);
+  if (!pop_file.IsOpen()) { result.message += (result.message.empty() ? "" : "; ") + std::string("Could not open pop file ") + pop_fpath; return; }
+  const char * sep = "===";
+  const char * fdom_end = std::search(pop_file.GetData(), pop_file.GetEnd(), sep, sep + 3);
+  std::ofstream fdom_ofstream(run_dir + "/fdom.gp", std::ios::binary);
+  fdom_ofstream.write(pop_file.GetData(), fdom_end - pop_file.GetData());
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cout << "usage: " << argv[0] << " data_directory benchmark [-u update] [-f fitness_file] [-m run_match] [-t threads] [-o dump_dir] [-d fdom_update]" << std::endl;
+    exit(-1);
+  }
+  const std::string data_dir = argv[1];
+  const std::string benchmark = argv[2];
+  std::string update = "";
+  std::string fit_fname = "output/fitness.csv";
+  std::string run_match = "";
+  std::string dump_dir = "./aggregated_data";
+  std::string fdom_update = "";
+  size_t thread_cnt = std::max<size_t>(1, std::thread::hardware_concurrency());
+  for (int i = 3; i < argc; i += 2) {
+    const std::string flag = argv[i];
+    if (i + 1 >= argc) { std::cout << "Missing value for " << flag << ". Exiting..." << std::endl; exit(-1); }
+    const std::string val = argv[i + 1];
+    if (flag == "-u") update = val;
+    else if (flag == "-f") fit_fname = val;
+    else if (flag == "-m") run_match = val;
+    else if (flag == "-t") thread_cnt = std::max(1, std::stoi(val));
+    else if (flag == "-o") dump_dir = val;
+    else if (flag == "-d") fdom_update = val;
+    else { std::cout << "Unrecognized option " << flag << ". Exiting..." << std::endl; exit(-1); }
+  }
+
+  // Get a list of all runs.
+  std::vector<RunResult> results;
+  DIR * dir = opendir(data_dir.c_str());
+  if (!dir) { std::cout << "Failed to open data directory (" << data_dir << "). Exiting..." << std::endl; exit(-1); }
+  while (struct dirent * entry = readdir(dir)) {
+    const std::string run = entry->d_name;
+    if (run == "." || run == "..") continue;
+    if (run.find(run_match) == std::string::npos) continue;
+    struct stat info;
+    if (stat((data_dir + "/" + run).c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) continue;
+    results.emplace_back();
+    results.back().run = run;
+  }
+  closedir(dir);
+  std::sort(results.begin(), results.end(), [](const RunResult & a, const RunResult & b) { return a.run < b.run; });
+
+  // Aggregate runs in parallel.
+  std::atomic<size_t> next_run(0);
+  auto worker = [&]() {
+    for (size_t i = next_run++; i < results.size(); i = next_run++) {
+      AggregateRun(data_dir, fit_fname, update, results[i]);
+      if (!fdom_update.empty()) ExtractFDom(data_dir, fdom_update, results[i]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < std::min(thread_cnt, results.size()); ++t) threads.emplace_back(worker);
+  worker();
+  for (std::thread & t : threads) t.join();
+
+  // Write out aggregated data (in run order).
+  const std::string dump = dump_dir + "/" + benchmark;
+  mkdir(dump_dir.c_str(), ACCESSPERMS);
+  mkdir(dump.c_str(), ACCESSPERMS);
+  const std::string out_fpath = dump + "/" + (update.empty() ? std::string("final_fitness.csv") : "fitness_" + update + ".csv");
+  std::ofstream out_ofstream(out_fpath);
+  out_ofstream << "benchmark,treatment,run_id,final_update,mean_fitness,max_fitness\n";
+  size_t aggregated_cnt = 0;
+  for (const RunResult & result : results) {
+    if (!result.message.empty()) std::cout << "Run " << result.run << ": " << result.message << std::endl;
+    if (!result.valid) continue;
+    const size_t split = result.run.rfind('_');
+    const std::string treatment = (split == std::string::npos) ? "" : result.run.substr(0, split);
+    const std::string run_id = (split == std::string::npos) ? result.run : result.run.substr(split + 1);
+    out_ofstream << benchmark << "," << treatment << "," << run_id << "," << result.update << ","
+                 << result.mean_fitness << "," << result.max_fitness << "\n";
+    ++aggregated_cnt;
+  }
+  out_ofstream.close();
+  std::cout << "Aggregated " << aggregated_cnt << " of " << results.size() << " runs into " << out_fpath << std::endl;
+  return 0;
+}
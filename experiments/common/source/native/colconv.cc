@@ -0,0 +1,56 @@
+// Converts binary columnar data files (see ColumnarFile.h) to CSV.
+//
+// usage: colconv FILE [-o OUTPUT] [-s]
+//   -o OUTPUT   Write CSV to OUTPUT (default: standard output).
+//   -s          Print schema and per-block column min/max (instead of CSV).
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../ColumnarFile.h"
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: " << argv[0] << " FILE [-o OUTPUT] [-s]" << std::endl;
+    exit(-1);
+  }
+  const std::string in_fpath = argv[1];
+  std::string out_fpath = "";
+  bool stats_only = false;
+  for (int i = 2; i < argc; ++i) {
+    const std::string flag = argv[i];
+    if (flag == "-s") stats_only = true;
+    else if (flag == "-o" && i + 1 < argc) out_fpath = argv[++i];
+    else { std::cout << "Unrecognized option " << flag << ". Exiting..." << std::endl; exit(-1); }
+  }
+
+  ColumnarReader reader;
+  if (!reader.Open(in_fpath)) {
+    std::cerr << "Failed to read columnar file (" << in_fpath << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  std::ofstream out_ofstream;
+  if (out_fpath != "") out_ofstream.open(out_fpath);
+  std::ostream & os = (out_fpath != "") ? out_ofstream : std::cout;
+
+  if (stats_only) {
+    const char * type_names[] = {"int", "uint", "double"};
+    for (const auto & col : reader.GetColumns()) os << col.name << " (" << type_names[col.type] << "): " << col.desc << "\n";
+    for (size_t block = 0; reader.NextBlock(); ++block) {
+      os << "Block " << block << " (" << reader.GetBlockRows() << " rows):";
+      for (const auto & col : reader.GetColumns()) {
+        os << " " << col.name << "=[";
+        columnar::Print(os, col.type, col.min);
+        os << ",";
+        columnar::Print(os, col.type, col.max);
+        os << "]";
+      }
+      os << "\n";
+    }
+  } else {
+    reader.PrintHeader(os);
+    while (reader.NextBlock()) reader.PrintBlock(os);
+  }
+  return 0;
+}
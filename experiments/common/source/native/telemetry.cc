@@ -0,0 +1,42 @@
+// Prints a running experiment's telemetry page (see Telemetry.h and TELEMETRY_SHM_NAME).
+//
+// usage: telemetry NAME [-w SECONDS]
+//   -w SECONDS  Keep printing the page every SECONDS seconds (until the page goes away).
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../Telemetry.h"
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: " << argv[0] << " NAME [-w SECONDS]" << std::endl;
+    exit(-1);
+  }
+  const std::string shm_name = argv[1];
+  double watch_sec = 0;
+  for (int i = 2; i < argc; ++i) {
+    const std::string flag = argv[i];
+    if (flag == "-w" && i + 1 < argc) watch_sec = std::stod(argv[++i]);
+    else { std::cout << "Unrecognized option " << flag << ". Exiting..." << std::endl; exit(-1); }
+  }
+
+  emp::vector<std::string> names;
+  emp::vector<double> values;
+  uint64_t pid = 0;
+  uint64_t publish_cnt = 0;
+  for (size_t reads = 0; ; ++reads) {
+    if (!TelemetryPage::Read(shm_name, names, values, pid, publish_cnt)) {
+      if (reads) return 0;  // Run finished.
+      std::cerr << "Failed to read telemetry page (" << shm_name << "). Exiting..." << std::endl;
+      exit(-1);
+    }
+    std::cout << "pid " << pid << " (" << publish_cnt << " publications)\n";
+    for (size_t i = 0; i < names.size(); ++i) std::cout << "  " << names[i] << ": " << values[i] << "\n";
+    std::cout << std::flush;
+    if (watch_sec <= 0) return 0;
+    std::this_thread::sleep_for(std::chrono::duration<double>(watch_sec));
+  }
+}
@@ -0,0 +1,225 @@
+#ifndef DEME_TOPOLOGY_H
+#define DEME_TOPOLOGY_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include "base/assert.h"
+#include "base/vector.h"
+#include "tools/Random.h"
+#include "tools/math.h"
+
+/// Neighbor network over the hardware units in a deme, stored as a compressed sparse row (CSR)
+/// adjacency array: the neighbors of node i are neighbors[row_offsets[i]] ... neighbors[row_offsets[i+1]-1].
+/// - Neighbor order within a row matters: it defines agent facing directions (direction d of node i is
+///   the d'th entry in row i), and rotating clockwise/counter-clockwise steps backward/forward through the row.
+/// - All builders produce undirected networks (if j is a neighbor of i, i is a neighbor of j).
+class DemeTopology {
+protected:
+  emp::vector<size_t> row_offsets;  ///< Size = node count + 1.
+  emp::vector<size_t> neighbors;    ///< Concatenated neighbor rows.
+  size_t max_degree;
+
+  static bool Adjacent(const emp::vector<emp::vector<size_t>> & adj, size_t a, size_t b) {
+    return std::find(adj[a].begin(), adj[a].end(), b) != adj[a].end();
+  }
+
+  static void RemoveEdge(emp::vector<emp::vector<size_t>> & adj, size_t a, size_t b) {
+    adj[a].erase(std::find(adj[a].begin(), adj[a].end(), b));
+    adj[b].erase(std::find(adj[b].begin(), adj[b].end(), a));
+  }
+
+public:
+  DemeTopology() : row_offsets(1, 0), neighbors(), max_degree(0) { ; }
+
+  size_t GetSize() const { return row_offsets.size() - 1; }
+  size_t GetEdgeCnt() const { return neighbors.size(); }   ///< Number of directed edges (2x undirected).
+  size_t GetMaxDegree() const { return max_degree; }
+
+  size_t GetDegree(size_t id) const {
+    emp_assert(id < GetSize());
+    return row_offsets[id+1] - row_offsets[id];
+  }
+
+  /// Get the i'th neighbor of node id.
+  size_t GetNeighbor(size_t id, size_t i) const {
+    emp_assert(i < GetDegree(id));
+    return neighbors[row_offsets[id] + i];
+  }
+
+  /// Iterate over neighbors of id: for (const size_t * n = RowBegin(id); n != RowEnd(id); ++n) ...
+  const size_t * RowBegin(size_t id) const { return neighbors.data() + row_offsets[id]; }
+  const size_t * RowEnd(size_t id) const { return neighbors.data() + row_offsets[id+1]; }
+
+  /// Build from adjacency lists (rows are used in given order).
+  static DemeTopology FromAdjacency(const emp::vector<emp::vector<size_t>> & adj) {
+    DemeTopology topo;
+    topo.row_offsets.resize(adj.size() + 1);
+    topo.row_offsets[0] = 0;
+    for (size_t i = 0; i < adj.size(); ++i) {
+      topo.row_offsets[i+1] = topo.row_offsets[i] + adj[i].size();
+      topo.max_degree = std::max(topo.max_degree, adj[i].size());
+    }
+    topo.neighbors.reserve(topo.row_offsets.back());
+    for (const emp::vector<size_t> & row : adj) {
+      for (size_t n : row) topo.neighbors.emplace_back(n);
+    }
+    return topo;
+  }
+
+  static DemeTopology VonNeumannTorus(size_t width, size_t height);
+  static DemeTopology MooreTorus(size_t width, size_t height);
+  static DemeTopology Ring(size_t num_nodes, size_t degree);
+  static DemeTopology RandomRegular(size_t num_nodes, size_t degree, emp::Random & rnd);
+  static DemeTopology SmallWorld(size_t num_nodes, size_t degree, double rewire_prob, emp::Random & rnd);
+  static bool LoadEdgeList(std::istream & is, size_t num_nodes, DemeTopology & topo, std::ostream & err=std::cerr);
+};
+
+/// 4-neighbor torus. Row order: up, left, down, right.
+DemeTopology DemeTopology::VonNeumannTorus(size_t width, size_t height) {
+  emp::vector<emp::vector<size_t>> adj(width * height);
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      const size_t up = (size_t)emp::Mod((int)y - 1, (int)height);
+      const size_t down = (size_t)emp::Mod((int)y + 1, (int)height);
+      const size_t left = (size_t)emp::Mod((int)x - 1, (int)width);
+      const size_t right = (size_t)emp::Mod((int)x + 1, (int)width);
+      adj[y*width + x] = { up*width + x, y*width + left, down*width + x, y*width + right };
+    }
+  }
+  return FromAdjacency(adj);
+}
+
+/// 8-neighbor torus. Row order (counter-clockwise, starting from up): up, up-left, left, down-left,
+/// down, down-right, right, up-right.
+DemeTopology DemeTopology::MooreTorus(size_t width, size_t height) {
+  emp::vector<emp::vector<size_t>> adj(width * height);
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      const size_t up = (size_t)emp::Mod((int)y - 1, (int)height);
+      const size_t down = (size_t)emp::Mod((int)y + 1, (int)height);
+      const size_t left = (size_t)emp::Mod((int)x - 1, (int)width);
+      const size_t right = (size_t)emp::Mod((int)x + 1, (int)width);
+      adj[y*width + x] = { up*width + x, up*width + left, y*width + left, down*width + left,
+                           down*width + x, down*width + right, y*width + right, up*width + right };
+    }
+  }
+  return FromAdjacency(adj);
+}
+
+/// Ring lattice; each node is connected to the degree/2 nearest nodes on either side.
+/// Row order: i-1, i+1, i-2, i+2, ...
+DemeTopology DemeTopology::Ring(size_t num_nodes, size_t degree) {
+  emp_assert(degree % 2 == 0 && degree < num_nodes, "Ring degree must be even and less than node count.");
+  emp::vector<emp::vector<size_t>> adj(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    for (size_t r = 1; r <= degree / 2; ++r) {
+      adj[i].emplace_back((i + num_nodes - r) % num_nodes);
+      adj[i].emplace_back((i + r) % num_nodes);
+    }
+  }
+  return FromAdjacency(adj);
+}
+
+/// Uniform-ish random k-regular graph (no self-loops or parallel edges). Pairs random free 'stubs'
+/// one edge at a time, restarting from scratch if it paints itself into a corner.
+DemeTopology DemeTopology::RandomRegular(size_t num_nodes, size_t degree, emp::Random & rnd) {
+  emp_assert((num_nodes * degree) % 2 == 0 && degree < num_nodes, "No such regular graph.");
+  emp::vector<emp::vector<size_t>> adj(num_nodes);
+  emp::vector<size_t> stubs;
+  bool done = false;
+  while (!done) {
+    for (emp::vector<size_t> & row : adj) row.clear();
+    stubs.clear();
+    for (size_t i = 0; i < num_nodes; ++i) {
+      for (size_t k = 0; k < degree; ++k) stubs.emplace_back(i);
+    }
+    done = true;
+    while (!stubs.empty()) {
+      bool paired = false;
+      for (size_t tries = 0; tries < 64 && !paired; ++tries) {
+        const size_t a = rnd.GetUInt(stubs.size());
+        const size_t b = rnd.GetUInt(stubs.size());
+        const size_t u = stubs[a], v = stubs[b];
+        if (u == v || Adjacent(adj, u, v)) continue;
+        adj[u].emplace_back(v);
+        adj[v].emplace_back(u);
+        // Remove both stubs (larger index first so the smaller index stays valid).
+        stubs[std::max(a, b)] = stubs.back(); stubs.pop_back();
+        stubs[std::min(a, b)] = stubs.back(); stubs.pop_back();
+        paired = true;
+      }
+      if (!paired) { done = false; break; }
+    }
+  }
+  return FromAdjacency(adj);
+}
+
+/// Watts-Strogatz small-world network: ring lattice of given degree where each lattice edge (i, i+r) is,
+/// with probability rewire_prob, replaced by an edge from i to a uniformly random non-neighbor.
+/// Every node keeps at least degree/2 neighbors.
+DemeTopology DemeTopology::SmallWorld(size_t num_nodes, size_t degree, double rewire_prob, emp::Random & rnd) {
+  emp_assert(degree % 2 == 0 && degree < num_nodes, "Small-world degree must be even and less than node count.");
+  emp::vector<emp::vector<size_t>> adj(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    for (size_t r = 1; r <= degree / 2; ++r) {
+      adj[i].emplace_back((i + num_nodes - r) % num_nodes);
+      adj[i].emplace_back((i + r) % num_nodes);
+    }
+  }
+  for (size_t r = 1; r <= degree / 2; ++r) {
+    for (size_t i = 0; i < num_nodes; ++i) {
+      const size_t j = (i + r) % num_nodes;
+      if (!rnd.P(rewire_prob) || adj[i].size() >= num_nodes - 1) continue;
+      size_t k = rnd.GetUInt(num_nodes);
+      while (k == i || Adjacent(adj, i, k)) k = rnd.GetUInt(num_nodes);
+      RemoveEdge(adj, i, j);
+      adj[i].emplace_back(k);
+      adj[k].emplace_back(i);
+    }
+  }
+  return FromAdjacency(adj);
+}
+
+/// Load undirected network from an edge-list file: one 'a b' pair of node IDs (in [0:num_nodes)) per
+/// line; blank lines and anything after '#' are ignored. Self-loops and repeated edges are skipped
+/// with a warning. Returns false (after reporting the offending line) on malformed input or if any
+/// node is left without neighbors.
+bool DemeTopology::LoadEdgeList(std::istream & is, size_t num_nodes, DemeTopology & topo, std::ostream & err) {
+  emp::vector<emp::vector<size_t>> adj(num_nodes);
+  std::string line;
+  size_t line_num = 0;
+  while (std::getline(is, line)) {
+    ++line_num;
+    line = line.substr(0, line.find('#'));
+    std::istringstream line_ss(line);
+    long long a, b;
+    if (!(line_ss >> a)) continue; // Blank line.
+    std::string extra;
+    if (!(line_ss >> b) || (line_ss >> extra)) {
+      err << "Edge list line " << line_num << ": expected 'a b', found '" << line << "'" << std::endl;
+      return false;
+    }
+    if (a < 0 || b < 0 || (size_t)a >= num_nodes || (size_t)b >= num_nodes) {
+      err << "Edge list line " << line_num << ": node ID out of range [0:" << num_nodes << ")" << std::endl;
+      return false;
+    }
+    if (a == b || Adjacent(adj, (size_t)a, (size_t)b)) {
+      err << "Edge list line " << line_num << ": skipping self-loop/repeated edge (" << a << ", " << b << ")" << std::endl;
+      continue;
+    }
+    adj[(size_t)a].emplace_back((size_t)b);
+    adj[(size_t)b].emplace_back((size_t)a);
+  }
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (adj[i].empty()) {
+      err << "Edge list: node " << i << " has no neighbors." << std::endl;
+      return false;
+    }
+  }
+  topo = FromAdjacency(adj);
+  return true;
+}
+
+#endif
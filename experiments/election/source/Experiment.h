@@ -6,11 +6,17 @@
 #include <string>
 #include <utility>
 #include <fstream>
+#include <sstream>
+#include <cmath>
 #include <sys/stat.h>
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <deque>
 #include <unordered_set>
+#include <atomic>
+#include <thread>
+#include <chrono>
 
 #include "base/Ptr.h"  
 #include "base/vector.h"
@@ -29,10 +35,37 @@
 
 #include "consensus-config.h"
 #include "SGPDeme.h"
+#include "VoteTally.h"
+#include "AllocCounter.h"
+#include "GenomeCodec.h"
+#include "IslandMigrator.h"
+#include "WorldDataFiles.h"
+#include "CompactSystematicsTracker.h"
+#include "MutationalLandscape.h"
+#include "ProgramLoader.h"
+#include "MemoryUsage.h"
+#include "Telemetry.h"
 
 constexpr size_t RUN_ID__EXP = 0;
 constexpr size_t RUN_ID__ANALYSIS = 1;
 
+constexpr size_t ANALYSIS_ID__LANDSCAPE = 0;
+constexpr size_t ANALYSIS_ID__SWEEP = 1;
+constexpr size_t ANALYSIS_ID__SNAPSHOTS = 2;
+
+constexpr size_t DATA_FORMAT_ID__CSV = 0;
+constexpr size_t DATA_FORMAT_ID__COLUMNAR = 1;
+
+constexpr size_t SYSTEMATICS_MODE_ID__WORLD = 0;
+constexpr size_t SYSTEMATICS_MODE_ID__COMPACT = 1;
+
+constexpr size_t TOPOLOGY_ID__VON_NEUMANN = 0;
+constexpr size_t TOPOLOGY_ID__MOORE = 1;
+constexpr size_t TOPOLOGY_ID__RING = 2;
+constexpr size_t TOPOLOGY_ID__RANDOM_REGULAR = 3;
+constexpr size_t TOPOLOGY_ID__SMALL_WORLD = 4;
+constexpr size_t TOPOLOGY_ID__EDGE_LIST = 5;
+
 constexpr size_t TAG_WIDTH = 16;
 
 constexpr uint32_t MIN_UID = 1;
@@ -57,6 +90,9 @@ public:
   // Hardware/agent aliases.
   using hardware_t = emp::EventDrivenGP_AW<TAG_WIDTH>;
   using program_t = hardware_t::Program;
+  using codec_t = GenomeCodec<hardware_t>;
+  using landscape_t = MutationalLandscape<hardware_t>;
+  using program_loader_t = ProgramLoader<hardware_t>;
   using state_t = hardware_t::State;
   using inst_t = hardware_t::inst_t;
   using inst_lib_t = hardware_t::inst_lib_t;
@@ -65,10 +101,16 @@ public:
   using memory_t = hardware_t::memory_t;
   using tag_t = hardware_t::affinity_t;
   using exec_stk_t = hardware_t::exec_stk_t;
+  using fast_hardware_t = FastEventDrivenGP_AW<TAG_WIDTH>;
+  using dispatch_table_t = fast_hardware_t::dispatch_table_t;
+  using shared_program_t = fast_hardware_t::shared_program_t;
+  using shared_program_ptr_t = fast_hardware_t::shared_program_ptr_t;
   // Deme alias
   using deme_t = ConsensusDeme;
   // World alias
   using world_t = emp::World<Agent>;
+  using island_migrator_t = IslandMigrator<world_t, codec_t>;
+  using compact_sys_t = CompactSystematicsTracker<world_t, codec_t>;
     // Task aliases
   using task_io_t = uint32_t;
 
@@ -76,16 +118,35 @@ public:
   struct Agent {
     size_t agent_id;
     program_t program;
-
-    Agent(const program_t & _p) : agent_id(0), program(_p) { ; }
-    Agent(const Agent && in) : agent_id(in.GetID()), program(in.program) { ; }
-    Agent(const Agent & in): agent_id(in.GetID()), program(in.program) { ; }
+    shared_program_ptr_t shared_program;  ///< Immutable copy of program for hardware to share; cleared on mutation.
+
+    // Copies (but not moves) count as genome copies (see AllocCounter.h).
+    Agent(const program_t & _p) : agent_id(0), program(_p), shared_program() { CountGenomeCopy(); }
+    Agent(program_t && _p) : agent_id(0), program(std::move(_p)), shared_program() { ; }
+    Agent(Agent && in) = default;
+    Agent(const Agent & in): agent_id(in.GetID()), program(in.program), shared_program(in.shared_program) { CountGenomeCopy(); }
+
+    Agent & operator=(Agent && in) = default;
+    Agent & operator=(const Agent & in) {
+      if (this == &in) return *this;
+      agent_id = in.agent_id;
+      program = in.program;
+      shared_program = in.shared_program;
+      CountGenomeCopy();
+      return *this;
+    }
 
     size_t GetID() const { return agent_id; }
     void SetID(size_t id) { agent_id = id; }
 
     program_t & GetGenome() { return program; }
 
+    /// Get shared (immutable) copy of program, making it (decoded against dispatch table) if necessary.
+    shared_program_ptr_t GetSharedProgram(emp::Ptr<const dispatch_table_t> table) {
+      if (!shared_program) shared_program = std::make_shared<const shared_program_t>(program, table);
+      return shared_program;
+    }
+
   };
 
   /// Wrapper around SGPDeme that includes useful propagule/activation functions.
@@ -100,70 +161,51 @@ public:
   protected:
 
     size_t phen_id;
-    std::unordered_set<uint32_t> uids;
-    std::unordered_multiset<uint32_t> valid_votes; ///< Maintains the number of valid votes present in the deme at the end of the most recent deme-update.
-    size_t max_vote_cnt;                           ///< Highest vote count for any single valid UID.
-    size_t valid_vote_cnt;                         ///< Maintains total number of valid votes.
+    VoteTally tally;    ///< Maintains valid votes present in the deme at the end of the most recent deme-update.
 
     uint32_t min_uid;
     uint32_t max_uid;
-    uint32_t leader_uid;
 
   public:
-    ConsensusDeme(size_t _w, size_t _h, emp::Ptr<emp::Random> _rnd, emp::Ptr<inst_lib_t> _ilib, emp::Ptr<event_lib_t> _elib)
-    : SGPDeme(_w, _h, _rnd, _ilib, _elib), phen_id(0), uids(), valid_votes(), max_vote_cnt(0), min_uid(0), max_uid(0)
+    ConsensusDeme(size_t _w, size_t _h, emp::Ptr<emp::Random> _rnd, emp::Ptr<inst_lib_t> _ilib, emp::Ptr<event_lib_t> _elib,
+                  size_t _update_mode=UPDATE_MODE__ASYNC, size_t _tile_w=0, size_t _tile_h=0, size_t _threads=1)
+    : SGPDeme(_w, _h, _rnd, _ilib, _elib, _update_mode, _tile_w, _tile_h, _threads),
+      phen_id(0), tally(), min_uid(0), max_uid(0)
     {
+      tally.ClearCandidates(grid.size());
       for (size_t i = 0; i < grid.size(); ++i) {
         grid[i].SetTrait(TRAIT_ID__DEME_ID, i);
         grid[i].SetTrait(TRAIT_ID__UID, i+1);
-        uids.emplace(i+1);
+        tally.AddCandidate(i+1);
       }
 
       on_deme_single_advance_sig.AddAction([this]() {
-        valid_votes.clear();
-        valid_vote_cnt = 0;
-        max_vote_cnt = 0;
+        tally.Reset();
       });
     }
 
     size_t GetPhenID() const { return phen_id; }
     void SetPhenID(size_t id) { phen_id = id; }
 
-    size_t GetMaxVoteCnt() const { return max_vote_cnt; }
-    size_t GetValidVoteCnt() const { return valid_vote_cnt; }
+    size_t GetMaxVoteCnt() const { return tally.GetMaxVoteCnt(); }
+    size_t GetValidVoteCnt() const { return tally.GetValidVoteCnt(); }
     uint32_t GetLargestUID() const { return max_uid; }
     uint32_t GetSmallestUID() const { return min_uid; }
-    uint32_t GetLeaderUID() const { return leader_uid; }
-
-    void TallyVote(uint32_t vote) {
-       if (emp::Has(uids, vote)) {
-        valid_vote_cnt++;
-        // If so, add i's vote.
-        valid_votes.emplace(vote);
-        size_t cnt = valid_votes.count(vote);
-        if (cnt > max_vote_cnt) {
-          max_vote_cnt = cnt;
-          leader_uid = vote;
-        }
-      }
-    }
+    uint32_t GetLeaderUID() const { return tally.GetLeaderUID(); }
+
+    void TallyVote(uint32_t vote) { tally.Tally(vote); }
 
     /// Randomize unique identifiers for each agent (range of each: [MIN_UID:MAX_UID]). Function
     /// ensures uniqueness.
     void RandomizeUIDS() {
       emp_assert(MAX_UID - MIN_UID > grid.size());
-      uids.clear();
-      valid_votes.clear();
-      max_vote_cnt = 0;
-      valid_vote_cnt = 0;
+      tally.ClearCandidates(grid.size());
       min_uid = MAX_UID;
       max_uid = 0;
-      leader_uid = 0;
       for (size_t i = 0; i < grid.size(); ++i) {
-        size_t val = random->GetUInt(MIN_UID, MAX_UID);
-        while (emp::Has(uids, val)) { val = random->GetUInt(MIN_UID, MAX_UID); }
+        uint32_t val = random->GetUInt(MIN_UID, MAX_UID);
+        while (!tally.AddCandidate(val)) { val = random->GetUInt(MIN_UID, MAX_UID); }
         grid[i].SetTrait(TRAIT_ID__UID, val);
-        uids.emplace(val);
         if (val < min_uid) min_uid = val;
         if (val > max_uid) max_uid = val;
       }
@@ -176,6 +218,7 @@ public:
     double score;
     size_t total_full_consensus_time;  ///< Number of time steps that full consensus is maintained.
     size_t mr_full_consensus_time;
+    size_t first_full_consensus_time;  ///< First time step with full consensus (EVAL_TIME if never).
     size_t max_consensus_size;
     size_t valid_vote_cnt;        ///< How many valid votes at end of evaluation?
     size_t msgs_exchanged;
@@ -194,6 +237,7 @@ public:
       score = 0;
       total_full_consensus_time = 0;
       mr_full_consensus_time = 0;
+      first_full_consensus_time = 0;
       max_consensus_size = 0;
       valid_vote_cnt = 0;
       msgs_exchanged = 0;
@@ -203,6 +247,14 @@ public:
     }
   };
 
+  /// Deme/hardware settings an analysis worker uses instead of the configured ones (see Analysis_Sweep).
+  struct Treatment {
+    size_t deme_width;
+    size_t deme_height;
+    size_t msg_delay;
+    bool fork_on_msg;
+  };
+
 
 protected:
   // == Configurable experiment parameters ==
@@ -215,6 +267,16 @@ protected:
   std::string ANCESTOR_FPATH;
   size_t DEME_WIDTH;
   size_t DEME_HEIGHT;
+  size_t DEME_UPDATE_MODE;
+  size_t DEME_TILE_WIDTH;
+  size_t DEME_TILE_HEIGHT;
+  size_t DEME_THREADS;
+  size_t DEME_SCHEDULE_METHOD;
+  size_t DEME_SCHEDULE_POOL_SIZE;
+  size_t DEME_TOPOLOGY;
+  size_t DEME_TOPOLOGY_DEGREE;
+  double DEME_TOPOLOGY_REWIRE_PROB;
+  std::string DEME_TOPOLOGY_FPATH;
   size_t INBOX_CAPACITY;
   size_t TOURNAMENT_SIZE;
   size_t SELECTION_METHOD;
@@ -230,6 +292,8 @@ protected:
   size_t SGP_HW_MAX_CORES;
   size_t SGP_HW_MAX_CALL_DEPTH;
   double SGP_HW_MIN_BIND_THRESH;
+  bool SGP_HW_FAST_DISPATCH;
+  bool SGP_HW_FAST_RESET;
   size_t SGP__PROG_MAX_ARG_VAL;
   double SGP__PER_BIT__TAG_BFLIP_RATE;
   double SGP__PER_INST__SUB_RATE;
@@ -242,15 +306,60 @@ protected:
   size_t FITNESS_INTERVAL;
   size_t POP_SNAPSHOT_INTERVAL;
   std::string DATA_DIRECTORY;
+  size_t DATA_FILE_FORMAT;
+  size_t SYSTEMATICS_MODE;
+  size_t MEMORY_REPORT_INTERVAL;
+  std::string TELEMETRY_SHM_NAME;
+  size_t ISLAND_CNT;
+  size_t ISLAND_ID;
+  std::string ISLAND_SHM_NAME;
+  size_t ISLAND_MIGRATION_INTERVAL;
+  size_t ISLAND_MIGRANT_CNT;
+  size_t ANALYSIS;
+  std::string ANALYZE_AGENT_FPATH;
+  std::string ANALYZE_SNAPSHOT_FPATHS;
+  std::string ANALYSIS_OUTPUT_FNAME;
+  size_t ANALYSIS_THREADS;
+  size_t LANDSCAPE_MUTANT_CNT;
+  std::string SWEEP_ED_MSG_DELAYS;
+  std::string SWEEP_FORK_ON_MSG;
+  std::string SWEEP_DEME_SIZES;
+  std::string SWEEP_SUMMARY_FNAME;
 
   size_t DEME_SIZE;
 
+  bool is_analysis_worker;  ///< Evaluates analysis programs on behalf of another experiment.
+  emp::vector<emp::Ptr<Experiment>> analysis_workers; ///< Only used for parallel analysis (ANALYSIS_THREADS != 1).
+  emp::Ptr<WorkerPool> analysis_pool;
+  emp::Ptr<const ConsensusConfig> analysis_config;    ///< Used to make analysis workers after construction (Analysis_Sweep).
+
   emp::Ptr<emp::Random> random;
   emp::Ptr<world_t> world;
 
   emp::Ptr<inst_lib_t> inst_lib;
   emp::Ptr<event_lib_t> event_lib;
+  emp::Ptr<program_loader_t> program_loader;  ///< Loads .gp files (made once the instruction set is complete).
   emp::Ptr<deme_t> eval_deme;
+  emp::Ptr<dispatch_table_t> inst_dispatch;   ///< Only used if SGP_HW_FAST_DISPATCH.
+  emp::Ptr<island_migrator_t> island_migrator;  ///< Only used if ISLAND_CNT > 1.
+
+  /// Live stats published to the telemetry page (each generation, right after evaluation).
+  struct TelemetryStats {
+    double best_score;
+    double mean_score;
+    double gens_per_sec;
+    double insts_per_sec;
+    size_t core_steps;                                ///< Hardware core steps (~instructions) run as of last publication.
+    std::chrono::steady_clock::time_point time;       ///< Time of last publication.
+  };
+  emp::Ptr<TelemetryPage> telemetry;                 ///< Only used if TELEMETRY_SHM_NAME is set.
+  TelemetryStats telemetry_stats;
+
+  WorldColumnarFiles<world_t> columnar_files;  ///< Only used if DATA_FILE_FORMAT is columnar.
+
+  emp::Ptr<compact_sys_t> compact_sys;        ///< Only used if SYSTEMATICS_MODE is compact.
+
+  memory_usage::ProcMemory proc_memory;               ///< Most recent /proc/self/status sample (for memory file).
   
   using inbox_t = std::deque<event_t>;
   emp::vector<inbox_t> inboxes;
@@ -275,6 +384,40 @@ protected:
   emp::Signal<void(Agent &)> begin_agent_eval_sig;
   
   std::function<double(Agent &)> calc_score;
+  std::function<void(void)> advance_deme;         ///< Advance eval_deme by one update (see SetDemePipeline).
+
+  // Per-hardware deme advance pipeline stages: deliver => process => tally.
+  // Stages are picked in Config_HW and fixed at compile time (see SGPDeme::SingleAdvance(PIPELINE)).
+  struct DeliverStage__None {
+    void operator()(hardware_t & hw) const { ; }
+  };
+  struct DeliverStage__Delayed {
+    Experiment * exp;
+    void operator()(hardware_t & hw) const { exp->DoDelayDeliver((size_t)hw.GetTrait(TRAIT_ID__DEME_ID)); }
+  };
+  struct TallyStage__None {
+    void operator()(hardware_t & hw) const { ; }
+  };
+  struct TallyStage__Immediate {
+    Experiment * exp;
+    void operator()(hardware_t & hw) const { exp->eval_deme->TallyVote((uint32_t)hw.GetTrait(TRAIT_ID__OPINION)); }
+  };
+  template <typename DELIVER, typename TALLY>
+  struct HardwarePipeline {
+    DELIVER deliver;
+    TALLY tally;
+    void operator()(fast_hardware_t & hw) const {
+      deliver(hw);
+      hw.SingleProcess();
+      tally(hw);
+    }
+  };
+
+  template <typename DELIVER, typename TALLY>
+  void SetDemePipeline(const DELIVER & deliver, const TALLY & tally) {
+    const HardwarePipeline<DELIVER, TALLY> pipeline{deliver, tally};
+    advance_deme = [this, pipeline]() { eval_deme->SingleAdvance(pipeline); };
+  }
 
 
   // Some inbox utilities.
@@ -352,9 +495,11 @@ protected:
     begin_agent_eval_sig.Trigger(agent);
     size_t full_consensus_time = 0; 
     size_t mr_full_consensus_time = 0;
+    size_t first_full_consensus_time = EVAL_TIME;
     for (eval_time = 0; eval_time < EVAL_TIME; ++eval_time) {
-      eval_deme->SingleAdvance();
+      advance_deme();
       if (eval_deme->GetMaxVoteCnt() == DEME_SIZE) {
+        if (!full_consensus_time) first_full_consensus_time = eval_time;
         ++full_consensus_time;
         ++mr_full_consensus_time;
       } else {
@@ -365,6 +510,7 @@ protected:
     Phenotype & phen = agent_phen_cache[id];
     phen.total_full_consensus_time = full_consensus_time;  ///< Number of time steps that full consensus is maintained.
     phen.mr_full_consensus_time = mr_full_consensus_time;
+    phen.first_full_consensus_time = first_full_consensus_time;
     phen.max_consensus_size = eval_deme->GetMaxVoteCnt();
     phen.valid_vote_cnt = eval_deme->GetValidVoteCnt();        ///< How many valid votes at end of evaluation?
     phen.min_uid = eval_deme->GetSmallestUID();
@@ -373,6 +519,36 @@ protected:
     phen.score = calc_score(agent);
   }
 
+  /// Copy of program that uses this experiment's instruction library. (Hardware runs a program with the
+  /// instructions of the library it was made with, and instructions act on their library's experiment.)
+  program_t LocalizeProgram(const program_t & program) const {
+    program_t local_program(inst_lib);
+    for (size_t fp = 0; fp < program.GetSize(); ++fp) local_program.PushFunction(program[fp]);
+    return local_program;
+  }
+
+  /// Shared program (for this experiment's deme) for one of landscape's evaluations. Knockouts reuse the
+  /// parent's decoded program (local_parent; see SharedProgram).
+  shared_program_ptr_t GetLandscapeProgram(const landscape_t & landscape, size_t eval_id, shared_program_ptr_t local_parent) const {
+    if (eval_id == 0) return local_parent;
+    const auto & variant = landscape.GetEvalVariant(eval_id);
+    const program_t program(LocalizeProgram(landscape.GetProgram(eval_id)));
+    if (variant.type == landscape_t::VARIANT_KNOCKOUT) {
+      return std::make_shared<const shared_program_t>(*local_parent, program, variant.func, variant.inst);
+    }
+    return std::make_shared<const shared_program_t>(program, inst_dispatch);
+  }
+
+  /// Analysis: evaluate agent once using given random number seed; returns its score.
+  double EvaluateAnalysisTrial(Agent & agent, int seed) {
+    random->ResetSeed(seed);
+    eval_deme->SetProgram(agent.GetSharedProgram(inst_dispatch));
+    eval_deme->SetPhenID(agent.GetID());
+    agent_phen_cache[agent.GetID()].Reset();
+    Evaluate(agent);
+    return agent_phen_cache[agent.GetID()].GetScore();
+  }
+
   /// Test function.
   /// Exists to test features as I add them.
   void Test() {
@@ -386,7 +562,7 @@ protected:
     std::cout << "----------------------" << std::endl;
 
     agent.SetID(0);
-    eval_deme->SetProgram(agent.GetGenome());
+    eval_deme->SetProgram(agent.GetSharedProgram(inst_dispatch));
     eval_deme->SetPhenID(0);
     Phenotype & phen = agent_phen_cache[0];
     phen.Reset();
@@ -401,7 +577,7 @@ protected:
     size_t full_consensus_time = 0; 
     size_t mr_full_consensus_time = 0;
     for (eval_time = 0; eval_time < EVAL_TIME; ++eval_time) {
-      eval_deme->SingleAdvance();
+      advance_deme();
       if (eval_deme->GetMaxVoteCnt() == DEME_SIZE) {
         ++full_consensus_time;
         ++mr_full_consensus_time;
@@ -450,8 +626,14 @@ protected:
   }
 
 public:
-  Experiment(const ConsensusConfig & config)
-    : DEME_SIZE(0), inboxes(0),
+  /// If analysis_parent is given, this experiment is only used to evaluate the parent's analysis programs
+  /// (see EvaluateAnalysisTrial), using treatment's deme/hardware settings if given.
+  Experiment(const ConsensusConfig & config, emp::Ptr<const Experiment> analysis_parent=nullptr,
+             emp::Ptr<const Treatment> treatment=nullptr)
+    : DEME_SIZE(0), is_analysis_worker(analysis_parent != nullptr), analysis_workers(), analysis_pool(nullptr),
+      analysis_config(&config), inst_dispatch(nullptr), island_migrator(nullptr),
+      telemetry(nullptr), telemetry_stats{0, 0, 0, 0, 0, std::chrono::steady_clock::now()}, columnar_files(),
+      compact_sys(nullptr), inboxes(0),
       update(0), eval_time(0), dom_agent_id(0)
   {
     RUN_MODE = config.RUN_MODE();
@@ -462,6 +644,16 @@ public:
     TRIAL_CNT = config.TRIAL_CNT();
     DEME_WIDTH = config.DEME_WIDTH();
     DEME_HEIGHT = config.DEME_HEIGHT();
+    DEME_UPDATE_MODE = config.DEME_UPDATE_MODE();
+    DEME_TILE_WIDTH = config.DEME_TILE_WIDTH();
+    DEME_TILE_HEIGHT = config.DEME_TILE_HEIGHT();
+    DEME_THREADS = config.DEME_THREADS();
+    DEME_SCHEDULE_METHOD = config.DEME_SCHEDULE_METHOD();
+    DEME_SCHEDULE_POOL_SIZE = config.DEME_SCHEDULE_POOL_SIZE();
+    DEME_TOPOLOGY = config.DEME_TOPOLOGY();
+    DEME_TOPOLOGY_DEGREE = config.DEME_TOPOLOGY_DEGREE();
+    DEME_TOPOLOGY_REWIRE_PROB = config.DEME_TOPOLOGY_REWIRE_PROB();
+    DEME_TOPOLOGY_FPATH = config.DEME_TOPOLOGY_FPATH();
     INBOX_CAPACITY = config.INBOX_CAPACITY();
     ANCESTOR_FPATH = config.ANCESTOR_FPATH();
     TOURNAMENT_SIZE = config.TOURNAMENT_SIZE();
@@ -478,6 +670,8 @@ public:
     SGP_HW_MAX_CORES = config.SGP_HW_MAX_CORES();
     SGP_HW_MAX_CALL_DEPTH = config.SGP_HW_MAX_CALL_DEPTH();
     SGP_HW_MIN_BIND_THRESH = config.SGP_HW_MIN_BIND_THRESH();
+    SGP_HW_FAST_DISPATCH = config.SGP_HW_FAST_DISPATCH();
+    SGP_HW_FAST_RESET = config.SGP_HW_FAST_RESET();
     SGP__PROG_MAX_ARG_VAL = config.SGP__PROG_MAX_ARG_VAL();
     SGP__PER_BIT__TAG_BFLIP_RATE = config.SGP__PER_BIT__TAG_BFLIP_RATE();
     SGP__PER_INST__SUB_RATE = config.SGP__PER_INST__SUB_RATE();
@@ -490,14 +684,46 @@ public:
     FITNESS_INTERVAL = config.FITNESS_INTERVAL();
     POP_SNAPSHOT_INTERVAL = config.POP_SNAPSHOT_INTERVAL();
     DATA_DIRECTORY = config.DATA_DIRECTORY();
+    DATA_FILE_FORMAT = config.DATA_FILE_FORMAT();
+    SYSTEMATICS_MODE = config.SYSTEMATICS_MODE();
+    MEMORY_REPORT_INTERVAL = config.MEMORY_REPORT_INTERVAL();
+    TELEMETRY_SHM_NAME = config.TELEMETRY_SHM_NAME();
+    ISLAND_CNT = config.ISLAND_CNT();
+    ISLAND_ID = config.ISLAND_ID();
+    ISLAND_SHM_NAME = config.ISLAND_SHM_NAME();
+    ISLAND_MIGRATION_INTERVAL = config.ISLAND_MIGRATION_INTERVAL();
+    ISLAND_MIGRANT_CNT = config.ISLAND_MIGRANT_CNT();
+    ANALYSIS = config.ANALYSIS();
+    ANALYZE_AGENT_FPATH = config.ANALYZE_AGENT_FPATH();
+    ANALYZE_SNAPSHOT_FPATHS = config.ANALYZE_SNAPSHOT_FPATHS();
+    ANALYSIS_OUTPUT_FNAME = config.ANALYSIS_OUTPUT_FNAME();
+    ANALYSIS_THREADS = config.ANALYSIS_THREADS();
+    LANDSCAPE_MUTANT_CNT = config.LANDSCAPE_MUTANT_CNT();
+    SWEEP_ED_MSG_DELAYS = config.SWEEP_ED_MSG_DELAYS();
+    SWEEP_FORK_ON_MSG = config.SWEEP_FORK_ON_MSG();
+    SWEEP_DEME_SIZES = config.SWEEP_DEME_SIZES();
+    SWEEP_SUMMARY_FNAME = config.SWEEP_SUMMARY_FNAME();
+
+    if (treatment) {
+      DEME_WIDTH = treatment->deme_width;
+      DEME_HEIGHT = treatment->deme_height;
+      SGP_HW_ED_MSG_DELAY = treatment->msg_delay;
+      SGP_HW_FORK_ON_MSG = treatment->fork_on_msg;
+    }
 
     DEME_SIZE = DEME_WIDTH*DEME_HEIGHT;
 
+    // Workers evaluate whole programs in parallel; they advance their demes on a single thread.
+    if (is_analysis_worker) DEME_THREADS = 1;
+
     // Make the random number generator.
-    random = emp::NewPtr<emp::Random>(RANDOM_SEED);
+    // (Islands each get their own seed.)
+    random = emp::NewPtr<emp::Random>(ISLAND_CNT > 1 ? RANDOM_SEED + (int)ISLAND_ID : RANDOM_SEED);
 
     // Make the world!
     world = emp::NewPtr<world_t>(random, "World");
+    // Compact systematics replace the world's systematics manager (which would keep a genome per taxon).
+    if (SYSTEMATICS_MODE == SYSTEMATICS_MODE_ID__COMPACT) world->RemoveSystematics(0);
 
     // Build phenotype cache.
     agent_phen_cache.resize(POP_SIZE);
@@ -522,12 +748,31 @@ public:
         Config_Analysis();
         break;
     }
+    // Make workers (each with its own deme and random number generator) for parallel analysis.
+    // (Sweeps make their own workers for each treatment.)
+    if (RUN_MODE == RUN_ID__ANALYSIS && ANALYSIS_THREADS != 1 && !is_analysis_worker) {
+      size_t thread_cnt = ANALYSIS_THREADS;
+      if (thread_cnt == 0) thread_cnt = std::max<size_t>(1, std::thread::hardware_concurrency());
+      #if defined(EMP_TRACK_MEM) || defined(EMP_MEM_TRACK)
+      thread_cnt = 1; // Memory tracking is not thread safe.
+      #endif
+      analysis_pool = emp::NewPtr<WorkerPool>(thread_cnt);
+      if (ANALYSIS != ANALYSIS_ID__SWEEP) {
+        for (size_t i = 0; i < thread_cnt; ++i) analysis_workers.emplace_back(emp::NewPtr<Experiment>(config, this));
+      }
+    }
     // Test();
   }
 
   ~Experiment() {
+    for (auto worker : analysis_workers) worker.Delete();
+    if (analysis_pool) analysis_pool.Delete();
     world.Delete();
     eval_deme.Delete();
+    if (inst_dispatch) inst_dispatch.Delete();
+    if (island_migrator) island_migrator.Delete();
+    if (telemetry) telemetry.Delete();
+    program_loader.Delete();
     inst_lib.Delete();
     event_lib.Delete();
     random.Delete();
@@ -541,10 +786,11 @@ public:
           RunStep();
           if (update % POP_SNAPSHOT_INTERVAL == 0) do_pop_snapshot_sig.Trigger(update);
         }
+        if (island_migrator) island_migrator->Close();
+        columnar_files.Clear();
+        if (compact_sys) compact_sys.Delete();
         break;
       case RUN_ID__ANALYSIS:
-        std::cout << "Analysis mode not implemented yet..." << std::endl;
-        exit(-1);
         do_analysis_sig.Trigger();
         break;
       default:
@@ -555,21 +801,44 @@ public:
 
   void RunStep() {
     do_evaluation_sig.Trigger();
+    const size_t genome_copy_cnt = GetGenomeCopyCnt();
     do_selection_sig.Trigger();
+    const size_t repro_genome_copy_cnt = GetGenomeCopyCnt() - genome_copy_cnt;
+    if (ALLOC_COUNTER_ENABLED) std::cout << "Genome copies during reproduction: " << repro_genome_copy_cnt << std::endl;
     do_world_update_sig.Trigger();
+    // Selection births offspring through the world, which copies each from its parent's genome; check that
+    // nothing else copies genomes on the way (at most one copy per offspring, now the population).
+    emp_assert(repro_genome_copy_cnt <= world->GetSize(), repro_genome_copy_cnt, world->GetSize());
   }
 
   void Config_HW();
+  void Config_Topology();
+  void Config_Dispatch();
   void Config_Run();
   void Config_Analysis();
 
+  void Analysis_Landscape();
+  void Analysis_Sweep();
+  void Analysis_Snapshots();
+
   size_t Mutate(Agent & agent, emp::Random & rnd);
   double CalcFitness(Agent & agent) { return agent_phen_cache[agent.GetID()].GetScore(); } ;
 
   void InitPopulation_FromAncestorFile();
   void Snapshot_SingleFile(size_t update);
+  void Migrate();
 
   emp::DataFile & AddDominantFile(const std::string & fpath="dominant.csv");
+  template <typename DATA_FILE>
+  DATA_FILE & AddDominantColumns(DATA_FILE & file);
+
+  emp::DataFile & AddMemoryFile(const std::string & fpath="memory.csv");
+  size_t GetWorldMemoryBytes();
+  size_t GetSystematicsMemoryBytes();
+  size_t GetInboxMemoryBytes() const;
+  void SetupTelemetry();
+  void PublishTelemetry(double best_score, double mean_score);
+  size_t GetCoreStepCnt() const;
 
   // Instructions
   // (execution control)
@@ -578,9 +847,9 @@ public:
   static void Inst_Nand(hardware_t & hw, const inst_t & inst);
 
   //   - Orientation
-  static void Inst_RotCW(hardware_t & hw, const inst_t & inst);
-  static void Inst_RotCCW(hardware_t & hw, const inst_t & inst);
-  static void Inst_RandomDir(hardware_t & hw, const inst_t & inst);
+  void Inst_RotCW(hardware_t & hw, const inst_t & inst);
+  void Inst_RotCCW(hardware_t & hw, const inst_t & inst);
+  void Inst_RandomDir(hardware_t & hw, const inst_t & inst);
   static void Inst_GetDir(hardware_t & hw, const inst_t & inst);
   //   - Messaging
   static void Inst_SendMsgFacing(hardware_t & hw, const inst_t & inst);
@@ -598,6 +867,8 @@ public:
   void EventDriven_Delay__DispatchMessage_Broadcast(hardware_t & hw, const event_t & event);
   void Imperative__DispatchMessage_Send(hardware_t & hw, const event_t & event);
   void Imperative__DispatchMessage_Broadcast(hardware_t & hw, const event_t & event);
+  void Sync__DispatchMessage_Send(hardware_t & hw, const event_t & event);
+  void Sync__DispatchMessage_Broadcast(hardware_t & hw, const event_t & event);
   static void HandleEvent__Message_Forking(hardware_t & hw, const event_t & event);
   static void HandleEvent__Message_NonForking(hardware_t & hw, const event_t & event);
 };
@@ -639,17 +910,22 @@ void Experiment::Inst_Nand(hardware_t & hw, const inst_t & inst) {
   state.SetLocal(inst.args[2], ~(a&b));
 }
 
+/// Orientation instructions: number of directions is the number of neighbors the agent has in the
+/// deme topology (4 on the default von Neumann torus).
 void Experiment::Inst_RotCW(hardware_t & hw, const inst_t & inst) {
-  hw.SetTrait(TRAIT_ID__DIR, emp::Mod(hw.GetTrait(TRAIT_ID__DIR) - 1, deme_t::NUM_DIRS));
+  const size_t dir_cnt = eval_deme->GetNeighborCnt((size_t)hw.GetTrait(TRAIT_ID__DEME_ID));
+  hw.SetTrait(TRAIT_ID__DIR, emp::Mod(hw.GetTrait(TRAIT_ID__DIR) - 1, dir_cnt));
 }
 
 void Experiment::Inst_RotCCW(hardware_t & hw, const inst_t & inst) {
-  hw.SetTrait(TRAIT_ID__DIR, emp::Mod(hw.GetTrait(TRAIT_ID__DIR) + 1, deme_t::NUM_DIRS));
+  const size_t dir_cnt = eval_deme->GetNeighborCnt((size_t)hw.GetTrait(TRAIT_ID__DEME_ID));
+  hw.SetTrait(TRAIT_ID__DIR, emp::Mod(hw.GetTrait(TRAIT_ID__DIR) + 1, dir_cnt));
 }
 
 void Experiment::Inst_RandomDir(hardware_t & hw, const inst_t & inst) {
   state_t & state = hw.GetCurState();
-  state.SetLocal(inst.args[0], hw.GetRandom().GetUInt(0, deme_t::NUM_DIRS));
+  const size_t dir_cnt = eval_deme->GetNeighborCnt((size_t)hw.GetTrait(TRAIT_ID__DEME_ID));
+  state.SetLocal(inst.args[0], hw.GetRandom().GetUInt(0, dir_cnt));
 }
 
 void Experiment::Inst_GetDir(hardware_t & hw, const inst_t & inst) {
@@ -685,15 +961,11 @@ void Experiment::EventDriven__DispatchMessage_Send(hardware_t & hw, const event_
 
 void Experiment::EventDriven__DispatchMessage_Broadcast(hardware_t & hw, const event_t & event) {
   const size_t loc_id = (size_t)hw.GetTrait(TRAIT_ID__DEME_ID);
-  const size_t uid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_UP);
-  const size_t did = eval_deme->GetNeighborID(loc_id, deme_t::DIR_DOWN);
-  const size_t lid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_LEFT);
-  const size_t rid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_RIGHT);
-  eval_deme->GetHardware(uid).QueueEvent(event);  
-  eval_deme->GetHardware(did).QueueEvent(event);
-  eval_deme->GetHardware(lid).QueueEvent(event);
-  eval_deme->GetHardware(rid).QueueEvent(event);  
-  agent_phen_cache[eval_deme->GetPhenID()].msgs_exchanged += 4;
+  const DemeTopology & topo = eval_deme->GetTopology();
+  for (const size_t * n = topo.RowBegin(loc_id); n != topo.RowEnd(loc_id); ++n) {
+    eval_deme->GetHardware(*n).QueueEvent(event);
+  }
+  agent_phen_cache[eval_deme->GetPhenID()].msgs_exchanged += topo.GetDegree(loc_id);
 }
 
 void Experiment::EventDriven_Delay__DispatchMessage_Send(hardware_t & hw, const event_t & event) {
@@ -704,15 +976,11 @@ void Experiment::EventDriven_Delay__DispatchMessage_Send(hardware_t & hw, const
 
 void Experiment::EventDriven_Delay__DispatchMessage_Broadcast(hardware_t & hw, const event_t & event) {
   const size_t loc_id = (size_t)hw.GetTrait(TRAIT_ID__DEME_ID);
-  const size_t uid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_UP);
-  const size_t did = eval_deme->GetNeighborID(loc_id, deme_t::DIR_DOWN);
-  const size_t lid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_LEFT);
-  const size_t rid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_RIGHT);
-  DelayDelivery(uid, event);
-  DelayDelivery(did, event);
-  DelayDelivery(lid, event);
-  DelayDelivery(rid, event);
-  agent_phen_cache[eval_deme->GetPhenID()].msgs_exchanged += 4;
+  const DemeTopology & topo = eval_deme->GetTopology();
+  for (const size_t * n = topo.RowBegin(loc_id); n != topo.RowEnd(loc_id); ++n) {
+    DelayDelivery(*n, event);
+  }
+  agent_phen_cache[eval_deme->GetPhenID()].msgs_exchanged += topo.GetDegree(loc_id);
 }
 
 void Experiment::Imperative__DispatchMessage_Send(hardware_t & hw, const event_t & event) {
@@ -721,17 +989,28 @@ void Experiment::Imperative__DispatchMessage_Send(hardware_t & hw, const event_t
   agent_phen_cache[eval_deme->GetPhenID()].msgs_exchanged++;
 }
 
+/// Synchronous deme update mode: message delivery is deferred to the end of the deme update, and
+/// message counts are collected by the deme (so these may be called from worker threads).
+void Experiment::Sync__DispatchMessage_Send(hardware_t & hw, const event_t & event) {
+  const size_t loc_id = (size_t)hw.GetTrait(TRAIT_ID__DEME_ID);
+  eval_deme->PostMessage(loc_id, eval_deme->GetNeighborID(loc_id, (size_t)hw.GetTrait(TRAIT_ID__DIR)), event);
+}
+
+void Experiment::Sync__DispatchMessage_Broadcast(hardware_t & hw, const event_t & event) {
+  const size_t loc_id = (size_t)hw.GetTrait(TRAIT_ID__DEME_ID);
+  const DemeTopology & topo = eval_deme->GetTopology();
+  for (const size_t * n = topo.RowBegin(loc_id); n != topo.RowEnd(loc_id); ++n) {
+    eval_deme->PostMessage(loc_id, *n, event);
+  }
+}
+
 void Experiment::Imperative__DispatchMessage_Broadcast(hardware_t & hw, const event_t & event) {
   const size_t loc_id = (size_t)hw.GetTrait(TRAIT_ID__DEME_ID);
-  const size_t uid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_UP);
-  const size_t did = eval_deme->GetNeighborID(loc_id, deme_t::DIR_DOWN);
-  const size_t lid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_LEFT);
-  const size_t rid = eval_deme->GetNeighborID(loc_id, deme_t::DIR_RIGHT);
-  DeliverToInbox(uid, event);
-  DeliverToInbox(did, event);
-  DeliverToInbox(lid, event);
-  DeliverToInbox(rid, event);
-  agent_phen_cache[eval_deme->GetPhenID()].msgs_exchanged += 4;
+  const DemeTopology & topo = eval_deme->GetTopology();
+  for (const size_t * n = topo.RowBegin(loc_id); n != topo.RowEnd(loc_id); ++n) {
+    DeliverToInbox(*n, event);
+  }
+  agent_phen_cache[eval_deme->GetPhenID()].msgs_exchanged += topo.GetDegree(loc_id);
 }
 
 void Experiment::HandleEvent__Message_Forking(hardware_t & hw, const event_t & event) {
@@ -751,18 +1030,26 @@ void Experiment::InitPopulation_FromAncestorFile() {
   std::cout << "Initializing population from ancestor file!" << std::endl;
   // Configure the ancestor program.
   program_t ancestor_prog(inst_lib);
-  std::ifstream ancestor_fstream(ANCESTOR_FPATH);
-  if (!ancestor_fstream.is_open()) {
-    std::cout << "Failed to open ancestor program file(" << ANCESTOR_FPATH << "). Exiting..." << std::endl;
+  if (!program_loader->LoadFile(ANCESTOR_FPATH, ancestor_prog)) {
+    std::cout << "Failed to load ancestor program file (" << program_loader->GetError() << "). Exiting..." << std::endl;
     exit(-1);
   }
-  ancestor_prog.Load(ancestor_fstream);
   std::cout << " --- Ancestor program: ---" << std::endl;
   ancestor_prog.PrintProgramFull();
   std::cout << " -------------------------" << std::endl;
   world->Inject(ancestor_prog, 1);    // Inject a bunch of ancestors into the population.
 }
 
+/// Island model: send ISLAND_MIGRANT_CNT randomly chosen agents to the next island, and replace randomly
+/// chosen agents with migrants from the previous island.
+void Experiment::Migrate() {
+  program_t immigrant(inst_lib);
+  if (!island_migrator->Migrate(*world, *random, immigrant, [this](size_t pos) { if (compact_sys) compact_sys->TrackInjection(pos); }, std::cout)) {
+    std::cout << "Exiting..." << std::endl;
+    exit(-1);
+  }
+}
+
 void Experiment::Snapshot_SingleFile(size_t update) {
   std::string snapshot_dir = DATA_DIRECTORY + "pop_" + emp::to_string((int)update);
   mkdir(snapshot_dir.c_str(), ACCESSPERMS);
@@ -778,7 +1065,14 @@ void Experiment::Snapshot_SingleFile(size_t update) {
 
 emp::DataFile & Experiment::AddDominantFile(const std::string & fpath) {
   auto & file = world->SetupFile(fpath);
+  AddDominantColumns(file);
+  file.PrintHeaderKeys();
+  return file;
+}
 
+/// Add columns that describe the dominant genotype to file (an emp::DataFile or a ColumnarFile).
+template <typename DATA_FILE>
+DATA_FILE & Experiment::AddDominantColumns(DATA_FILE & file) {
   std::function<size_t(void)> get_update = [this](){ return world->GetUpdate(); };
   file.AddFun(get_update, "update", "Update");
 
@@ -837,10 +1131,126 @@ emp::DataFile & Experiment::AddDominantFile(const std::string & fpath) {
   };
   file.AddFun(get_max_uid, "leader_uid", "Leader UID for this evaluation?");
 
+  return file;
+}
+
+/// Memory file: estimated bytes held by each major subsystem (see MemoryUsage.h), plus the process's
+/// current and peak resident set size.
+emp::DataFile & Experiment::AddMemoryFile(const std::string & fpath) {
+  auto & file = world->SetupFile(fpath);
+  std::function<size_t(void)> get_update = [this](){ return world->GetUpdate(); };
+  file.AddFun(get_update, "update", "Update");
+  std::function<size_t(void)> get_world_bytes = [this]() { return this->GetWorldMemoryBytes(); };
+  file.AddFun(get_world_bytes, "world_bytes", "Population: agents, their programs, and their shared (decoded) programs");
+  std::function<size_t(void)> get_sys_bytes = [this]() { return this->GetSystematicsMemoryBytes(); };
+  if (SYSTEMATICS_MODE == SYSTEMATICS_MODE_ID__COMPACT) {
+    file.AddFun(get_sys_bytes, "systematics_bytes", "Systematics (compact systematics)");
+  } else {
+    file.AddFun(get_sys_bytes, "systematics_bytes_est", "Systematics (world systematics manager, estimated from taxon count)");
+  }
+  std::function<size_t(void)> get_phen_bytes = [this]() { return memory_usage::VectorBytes(agent_phen_cache); };
+  file.AddFun(get_phen_bytes, "phen_cache_bytes", "Phenotype cache (agent_phen_cache)");
+  std::function<size_t(void)> get_inbox_bytes = [this]() { return this->GetInboxMemoryBytes(); };
+  file.AddFun(get_inbox_bytes, "inbox_bytes", "Message inboxes (imperative hardware) and delayed messages");
+  std::function<size_t(void)> get_hw_bytes = [this]() { return sizeof(deme_t) + eval_deme->GetMemoryBytes(); };
+  file.AddFun(get_hw_bytes, "hardware_bytes", "Evaluation deme (hardware, deme program, posted messages)");
+  std::function<size_t(void)> get_rss = [this]() { proc_memory = memory_usage::ReadProcMemory(); return proc_memory.rss; };
+  file.AddFun(get_rss, "rss_bytes", "Resident set size");
+  std::function<size_t(void)> get_peak_rss = [this]() { return proc_memory.peak_rss; };
+  file.AddFun(get_peak_rss, "peak_rss_bytes", "Peak resident set size");
   file.PrintHeaderKeys();
   return file;
 }
 
+/// Telemetry page (see Telemetry.h): run progress and throughput, population score, the dominant agent's
+/// phenotype, and how full the deme's inboxes were at the end of the generation's last evaluation.
+void Experiment::SetupTelemetry() {
+  telemetry = emp::NewPtr<TelemetryPage>(TELEMETRY_SHM_NAME);
+  telemetry->AddStat("update", [this]() { return (double)update; });
+  telemetry->AddStat("gens_per_sec", [this]() { return telemetry_stats.gens_per_sec; });
+  telemetry->AddStat("insts_per_sec", [this]() { return telemetry_stats.insts_per_sec; });
+  telemetry->AddStat("best_score", [this]() { return telemetry_stats.best_score; });
+  telemetry->AddStat("mean_score", [this]() { return telemetry_stats.mean_score; });
+  telemetry->AddStat("dom_id", [this]() { return (double)dom_agent_id; });
+  telemetry->AddStat("dom_full_consensus_time", [this]() { return (double)agent_phen_cache[dom_agent_id].total_full_consensus_time; });
+  telemetry->AddStat("dom_max_consensus_size", [this]() { return (double)agent_phen_cache[dom_agent_id].max_consensus_size; });
+  telemetry->AddStat("dom_valid_vote_cnt", [this]() { return (double)agent_phen_cache[dom_agent_id].valid_vote_cnt; });
+  telemetry->AddStat("dom_msgs_sent", [this]() { return (double)agent_phen_cache[dom_agent_id].msgs_exchanged; });
+  telemetry->AddStat("dom_inst_cnt", [this]() { return (double)world->GetOrg(dom_agent_id).GetGenome().GetInstCnt(); });
+  telemetry->AddStat("inbox_msgs", [this]() {
+    size_t msgs = 0;
+    for (const inbox_t & inbox : inboxes) msgs += inbox.size();
+    return (double)msgs;
+  });
+  telemetry->AddStat("inbox_max_msgs", [this]() {
+    size_t max_msgs = 0;
+    for (const inbox_t & inbox : inboxes) max_msgs = std::max(max_msgs, inbox.size());
+    return (double)max_msgs;
+  });
+  telemetry->AddStat("rss_bytes", []() { return (double)memory_usage::ReadProcMemory().rss; });
+  if (!telemetry->Open(std::cout)) {
+    std::cout << "Failed to create telemetry page (" << TELEMETRY_SHM_NAME << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  telemetry_stats.core_steps = GetCoreStepCnt();
+  telemetry_stats.time = std::chrono::steady_clock::now();
+}
+
+/// Update throughput (since the last publication) and publish stats to the telemetry page.
+void Experiment::PublishTelemetry(double best_score, double mean_score) {
+  const auto now = std::chrono::steady_clock::now();
+  const double secs = std::chrono::duration<double>(now - telemetry_stats.time).count();
+  const size_t core_steps = GetCoreStepCnt();
+  telemetry_stats.best_score = best_score;
+  telemetry_stats.mean_score = mean_score;
+  telemetry_stats.gens_per_sec = (secs > 0) ? 1.0 / secs : 0;
+  telemetry_stats.insts_per_sec = (secs > 0) ? (double)(core_steps - telemetry_stats.core_steps) / secs : 0;
+  telemetry_stats.core_steps = core_steps;
+  telemetry_stats.time = now;
+  telemetry->Publish();
+}
+
+/// Core steps run by the evaluation deme's hardware so far.
+size_t Experiment::GetCoreStepCnt() const {
+  size_t steps = 0;
+  for (size_t id = 0; id < eval_deme->GetSize(); ++id) steps += eval_deme->GetHardware(id).GetCoreStepCnt();
+  return steps;
+}
+
+/// Bytes held by the population (shared programs are counted once, however many agents share them).
+size_t Experiment::GetWorldMemoryBytes() {
+  std::unordered_set<const shared_program_t *> shared;
+  size_t bytes = world->GetSize() * sizeof(emp::Ptr<Agent>);
+  for (size_t id = 0; id < world->GetSize(); ++id) {
+    if (!world->IsOccupied(id)) continue;
+    const Agent & agent = world->GetOrg(id);
+    bytes += sizeof(Agent) + memory_usage::ProgramBytes(agent.program);
+    if (agent.shared_program && shared.insert(agent.shared_program.get()).second) {
+      bytes += sizeof(shared_program_t) + agent.shared_program->GetMemoryBytes();
+    }
+  }
+  return bytes;
+}
+
+/// Bytes held by systematics. Compact systematics report their own size. The world's systematics manager
+/// keeps a taxon (with a copy of its genome) for every genotype it tracks; its size is estimated from the
+/// taxon count and the population's mean program size.
+size_t Experiment::GetSystematicsMemoryBytes() {
+  if (compact_sys) return compact_sys->GetMemoryBytes();
+  size_t prog_bytes = 0;
+  for (size_t id = 0; id < world->GetSize(); ++id) {
+    if (world->IsOccupied(id)) prog_bytes += memory_usage::ProgramBytes(world->GetOrg(id).program);
+  }
+  if (world->GetSize()) prog_bytes /= world->GetSize();
+  return world->GetSystematics().GetNumTaxa() * (memory_usage::TAXON_BYTES + sizeof(program_t) + prog_bytes);
+}
+
+size_t Experiment::GetInboxMemoryBytes() const {
+  size_t bytes = memory_usage::VectorBytes(inboxes);
+  for (const inbox_t & inbox : inboxes) bytes += memory_usage::EventQueueBytes(inbox);
+  return bytes;
+}
+
 // --- Configuration/setup function implementations ---
 void Experiment::Config_Run() {
   // Make data directory.
@@ -853,6 +1263,18 @@ void Experiment::Config_Run() {
   world->SetFitFun([this](Agent & agent) { return this->CalcFitness(agent); });
   world->SetMutFun([this](Agent &agent, emp::Random &rnd) { return this->Mutate(agent, rnd); }, ELITE_SELECT__ELITE_CNT);
 
+  // Join island ring (island model).
+  if (ISLAND_CNT > 1) {
+    island_migrator = emp::NewPtr<island_migrator_t>(ISLAND_SHM_NAME, ISLAND_CNT, ISLAND_ID, ISLAND_MIGRANT_CNT,
+                                                     codec_t::GetMaxBytes(SGP_PROG_MAX_FUNC_CNT, SGP_PROG_MAX_TOTAL_LEN));
+    if (!island_migrator->Open(std::cout)) {
+      std::cout << "Failed to join island ring (" << ISLAND_SHM_NAME << "). Exiting..." << std::endl;
+      exit(-1);
+    }
+  }
+  // Publish live stats (telemetry page).
+  if (TELEMETRY_SHM_NAME != "") this->SetupTelemetry();
+
   // === Setup signals! ===
   // On population initialization:
   do_pop_init_sig.AddAction([this]() {
@@ -863,12 +1285,33 @@ void Experiment::Config_Run() {
   do_begin_run_setup_sig.AddAction([this]() {
     std::cout << "Doing initial run setup." << std::endl;
     // Setup systematics/fitness tracking.
-    auto & sys_file = world->SetupSystematicsFile(DATA_DIRECTORY + "systematics.csv");
-    sys_file.SetTimingRepeat(SYSTEMATICS_INTERVAL);
-    auto & fit_file = world->SetupFitnessFile(DATA_DIRECTORY + "fitness.csv");
-    fit_file.SetTimingRepeat(FITNESS_INTERVAL);
-    this->AddDominantFile(DATA_DIRECTORY+"dominant.csv").SetTimingRepeat(SYSTEMATICS_INTERVAL);
+    if (SYSTEMATICS_MODE == SYSTEMATICS_MODE_ID__COMPACT) {
+      const bool columnar = DATA_FILE_FORMAT == DATA_FORMAT_ID__COLUMNAR;
+      compact_sys = emp::NewPtr<compact_sys_t>(*world, DATA_DIRECTORY + (columnar ? "systematics.sgpcol" : "systematics.csv"),
+                                               columnar, SYSTEMATICS_INTERVAL);
+    } else if (DATA_FILE_FORMAT == DATA_FORMAT_ID__COLUMNAR) {
+      columnar_files.AddSystematicsFile(*world, DATA_DIRECTORY + "systematics.sgpcol").SetTimingRepeat(SYSTEMATICS_INTERVAL);
+    } else {
+      auto & sys_file = world->SetupSystematicsFile(DATA_DIRECTORY + "systematics.csv");
+      sys_file.SetTimingRepeat(SYSTEMATICS_INTERVAL);
+    }
+    if (DATA_FILE_FORMAT == DATA_FORMAT_ID__COLUMNAR) {
+      columnar_files.AddFitnessFile(*world, DATA_DIRECTORY + "fitness.sgpcol").SetTimingRepeat(FITNESS_INTERVAL);
+      this->AddDominantColumns(columnar_files.Add(DATA_DIRECTORY + "dominant.sgpcol")).SetTimingRepeat(SYSTEMATICS_INTERVAL);
+      if (!columnar_files.IsGood(std::cout)) {
+        std::cout << "Exiting..." << std::endl;
+        exit(-1);
+      }
+    } else {
+      auto & fit_file = world->SetupFitnessFile(DATA_DIRECTORY + "fitness.csv");
+      fit_file.SetTimingRepeat(FITNESS_INTERVAL);
+      this->AddDominantFile(DATA_DIRECTORY+"dominant.csv").SetTimingRepeat(SYSTEMATICS_INTERVAL);
+    }
+    if (MEMORY_REPORT_INTERVAL) this->AddMemoryFile(DATA_DIRECTORY + "memory.csv").SetTimingRepeat(MEMORY_REPORT_INTERVAL);
     do_pop_init_sig.Trigger();
+    if (compact_sys) {
+      for (size_t pos = 0; pos < world->GetSize(); ++pos) compact_sys->TrackInjection(pos);
+    }
   });
 
   begin_agent_eval_sig.AddAction([this](Agent & agent) {
@@ -881,17 +1324,30 @@ void Experiment::Config_Run() {
   // On evaluation:
   do_evaluation_sig.AddAction([this]() {
     double best_score = -32767;
+    double total_score = 0;
+    size_t eval_alloc_cnt = 0;
     dom_agent_id = 0;
     for (size_t id = 0; id < world->GetSize(); ++id) {
       Agent & our_hero = world->GetOrg(id);
       our_hero.SetID(id);
-      eval_deme->SetProgram(our_hero.GetGenome());
+      eval_deme->SetProgram(our_hero.GetSharedProgram(inst_dispatch));
       eval_deme->SetPhenID(id);
       agent_phen_cache[id].Reset();
+      const size_t alloc_cnt = GetAllocCnt();
       this->Evaluate(our_hero);
+      eval_alloc_cnt += GetAllocCnt() - alloc_cnt;
       if (agent_phen_cache[id].GetScore() > best_score) { best_score = agent_phen_cache[id].GetScore(); dom_agent_id = id; }
+      total_score += agent_phen_cache[id].GetScore();
+    }
+    if (ALLOC_COUNTER_ENABLED) std::cout << "Heap allocations during evaluation: " << eval_alloc_cnt << std::endl;
+    // With hardware run-time state in arenas, evaluation must not touch the heap once the first update has
+    // sized the arenas' free lists and the hardware's containers.
+    if (ALLOC_COUNTER_ENABLED && TRIAL_ARENA_ENABLED && update > 0 && eval_alloc_cnt) {
+      std::cout << "Heap allocations during evaluation after warm-up (expected 0): " << eval_alloc_cnt << ". Exiting..." << std::endl;
+      exit(-1);
     }
     std::cout << "Update: " << update << " Max score: " << best_score << std::endl;
+    if (telemetry) this->PublishTelemetry(best_score, world->GetSize() ? total_score / (double)world->GetSize() : 0);
   });
   
   do_selection_sig.AddAction([this]() {
@@ -901,9 +1357,18 @@ void Experiment::Config_Run() {
   
   // Do world update action
   do_world_update_sig.AddAction([this]() {
+    columnar_files.Update(*world);
     world->Update();
+    if (compact_sys) compact_sys->Track();
   });
 
+  // Island model: migrate right after population turnover.
+  if (island_migrator && ISLAND_MIGRATION_INTERVAL) {
+    do_world_update_sig.AddAction([this]() {
+      if (update && update % ISLAND_MIGRATION_INTERVAL == 0) this->Migrate();
+    });
+  }
+
   // Do population snapshot action
   do_pop_snapshot_sig.AddAction([this](size_t update) { this->Snapshot_SingleFile(update); }); 
 
@@ -914,7 +1379,283 @@ void Experiment::Config_Run() {
 
 }
 
-void Experiment::Config_Analysis() { ; }
+void Experiment::Config_Analysis() {
+  begin_agent_eval_sig.AddAction([this](Agent & agent) {
+    // Randomize UIDS
+    eval_deme->RandomizeUIDS();
+  });
+
+  calc_score = [this](Agent & agent) {
+    Phenotype & phen = agent_phen_cache[agent.GetID()];
+    return (double)(phen.valid_vote_cnt + phen.max_consensus_size + (phen.total_full_consensus_time * DEME_SIZE));
+  };
+
+  if (is_analysis_worker) return;
+  switch (ANALYSIS) {
+    case ANALYSIS_ID__LANDSCAPE:
+      do_analysis_sig.AddAction([this]() { this->Analysis_Landscape(); });
+      break;
+    case ANALYSIS_ID__SWEEP:
+      do_analysis_sig.AddAction([this]() { this->Analysis_Sweep(); });
+      break;
+    case ANALYSIS_ID__SNAPSHOTS:
+      do_analysis_sig.AddAction([this]() { this->Analysis_Snapshots(); });
+      break;
+    default:
+      std::cout << "Unrecognized analysis. Exiting..." << std::endl;
+      exit(-1);
+  }
+}
+
+/// Mutational landscape of the agent in ANALYZE_AGENT_FPATH: evaluate (TRIAL_CNT times each) every
+/// single-instruction knockout, every function deletion, and LANDSCAPE_MUTANT_CNT random mutants (see
+/// MutationalLandscape), writing one row per variant. Every variant is evaluated with the same seeds as
+/// the parent, so fitness differences come from the mutation, not from sampling.
+void Experiment::Analysis_Landscape() {
+  program_t parent(inst_lib);
+  if (!program_loader->LoadFile(ANALYZE_AGENT_FPATH, parent)) {
+    std::cout << "Failed to load analysis program file (" << program_loader->GetError() << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  std::cout << " --- Analysis program: ---" << std::endl;
+  parent.PrintProgramFull();
+
+  landscape_t landscape(parent);
+  landscape.AddKnockouts(inst_lib->GetID("Nop"));
+  landscape.AddFunctionDeletions();
+  emp::Random mut_random(random->GetInt(1, 2000000000));
+  landscape.AddMutants(LANDSCAPE_MUTANT_CNT, [this, &mut_random](program_t & program) {
+    Agent mutant(std::move(program));
+    const size_t mut_cnt = this->Mutate(mutant, mut_random);
+    program = std::move(mutant.GetGenome());
+    return mut_cnt;
+  });
+  if (landscape.GetFailedMutantCnt()) {
+    std::cout << "Warning: failed to draw " << landscape.GetFailedMutantCnt() << " mutants (mutation rates too low?)" << std::endl;
+  }
+  std::cout << "Landscape: " << landscape.GetVariantCnt() << " variants (" << landscape.GetEvalCnt() << " distinct programs)" << std::endl;
+
+  emp::vector<int> trial_seeds(std::max<size_t>(1, TRIAL_CNT));
+  for (int & seed : trial_seeds) seed = random->GetInt(1, 2000000000);
+  emp::vector<double> eval_mean(landscape.GetEvalCnt()), eval_min(landscape.GetEvalCnt());
+  std::atomic<size_t> next_eval(0);
+  auto evaluate = [&landscape, &trial_seeds, &eval_mean, &eval_min, &next_eval](Experiment & evaluator) {
+    shared_program_ptr_t local_parent = std::make_shared<const shared_program_t>(evaluator.LocalizeProgram(landscape.GetParent()), evaluator.inst_dispatch);
+    for (size_t evalID = next_eval++; evalID < landscape.GetEvalCnt(); evalID = next_eval++) {
+      Agent our_hero(landscape.GetProgram(evalID));
+      our_hero.SetID(0);
+      our_hero.shared_program = evaluator.GetLandscapeProgram(landscape, evalID, local_parent);
+      double total = 0;
+      for (size_t tID = 0; tID < trial_seeds.size(); ++tID) {
+        const double score = evaluator.EvaluateAnalysisTrial(our_hero, trial_seeds[tID]);
+        total += score;
+        if (tID == 0 || score < eval_min[evalID]) eval_min[evalID] = score;
+      }
+      eval_mean[evalID] = total / (double)trial_seeds.size();
+    }
+  };
+  if (analysis_workers.empty()) evaluate(*this);
+  else analysis_pool->Run(analysis_workers.size(), [this, &evaluate](size_t w) { evaluate(*analysis_workers[w]); });
+
+  std::ofstream prog_ofstream("./"+ANALYSIS_OUTPUT_FNAME);
+  landscape.PrintTable(prog_ofstream, eval_mean, eval_min);
+  prog_ofstream.close();
+  std::cout << " --- Landscape summary (parent: mean score=" << eval_mean[0] << ", min score=" << eval_min[0] << "): ---" << std::endl;
+  landscape.PrintSummary(std::cout, eval_mean);
+}
+
+/// Treatment sweep: evaluate the agent in ANALYZE_AGENT_FPATH TRIAL_CNT times (with the same seeds) in
+/// every combination of SWEEP_ED_MSG_DELAYS, SWEEP_FORK_ON_MSG, and SWEEP_DEME_SIZES (each empty list
+/// means the configured setting). Writes one row per evaluation to ANALYSIS_OUTPUT_FNAME and consensus
+/// time and message count distributions per treatment to SWEEP_SUMMARY_FNAME. Consensus times are only
+/// taken from evaluations that reached full consensus (consensus_rate gives how many did); they are NA if
+/// none did.
+void Experiment::Analysis_Sweep() {
+  program_t program(inst_lib);
+  if (!program_loader->LoadFile(ANALYZE_AGENT_FPATH, program)) {
+    std::cout << "Failed to load analysis program file (" << program_loader->GetError() << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  std::cout << " --- Analysis program: ---" << std::endl;
+  program.PrintProgramFull();
+
+  // Build treatments.
+  auto parse_list = [](const std::string & list, const std::string & fallback) {
+    emp::vector<std::string> items;
+    emp::slice(list.empty() ? fallback : list, items, ',');
+    items.erase(std::remove(items.begin(), items.end(), std::string("")), items.end());
+    return items;
+  };
+  emp::vector<size_t> delays;
+  for (const std::string & item : parse_list(SWEEP_ED_MSG_DELAYS, emp::to_string(SGP_HW_ED_MSG_DELAY))) {
+    delays.emplace_back((size_t)std::stoul(item));
+  }
+  emp::vector<bool> forks;
+  for (const std::string & item : parse_list(SWEEP_FORK_ON_MSG, emp::to_string((size_t)SGP_HW_FORK_ON_MSG))) {
+    forks.emplace_back(std::stoul(item) != 0);
+  }
+  emp::vector<std::pair<size_t, size_t>> deme_sizes;
+  for (const std::string & item : parse_list(SWEEP_DEME_SIZES, emp::to_string(DEME_WIDTH) + "x" + emp::to_string(DEME_HEIGHT))) {
+    const size_t split = item.find('x');
+    if (split == std::string::npos || split == 0 || split + 1 == item.size()) {
+      std::cout << "Bad deme size in SWEEP_DEME_SIZES (" << item << "; expected WIDTHxHEIGHT). Exiting..." << std::endl;
+      exit(-1);
+    }
+    deme_sizes.emplace_back((size_t)std::stoul(item.substr(0, split)), (size_t)std::stoul(item.substr(split + 1)));
+  }
+  emp::vector<Treatment> treatments;
+  for (size_t delay : delays) {
+    for (bool fork : forks) {
+      for (const auto & deme_size : deme_sizes) treatments.emplace_back(Treatment{deme_size.first, deme_size.second, delay, fork});
+    }
+  }
+
+  emp::vector<int> seeds(std::max<size_t>(1, TRIAL_CNT));
+  for (int & seed : seeds) seed = random->GetInt(1, 2000000000);
+  const size_t thread_cnt = analysis_pool ? analysis_pool->GetSize() : 1;
+
+  std::ofstream eval_ofstream("./"+ANALYSIS_OUTPUT_FNAME);
+  std::ofstream summary_ofstream("./"+SWEEP_SUMMARY_FNAME);
+  const std::string treatment_header = "ed_msg_delay,fork_on_msg,deme_width,deme_height";
+  eval_ofstream << treatment_header << ",seed_id,score,first_consensus_time,total_consensus_time,final_consensus_streak,max_consensus_size,valid_votes,msgs_sent";
+  summary_ofstream << treatment_header << ",evaluations,consensus_rate,mean_score"
+                   << ",mean_consensus_time,min_consensus_time,q25_consensus_time,median_consensus_time,q75_consensus_time,max_consensus_time"
+                   << ",mean_msgs_sent,min_msgs_sent,q25_msgs_sent,median_msgs_sent,q75_msgs_sent,max_msgs_sent";
+
+  emp::vector<Phenotype> phens(seeds.size());
+  emp::vector<double> consensus_times, msg_cnts(seeds.size());
+  // Nearest-rank quantile (q in [0:1]) of sorted values.
+  auto quantile = [](const emp::vector<double> & sorted, double q) {
+    const size_t rank = std::max<size_t>(1, (size_t)std::ceil(q * (double)sorted.size()));
+    return sorted[rank - 1];
+  };
+  auto print_dist = [&quantile](std::ostream & os, emp::vector<double> & values) {
+    if (values.empty()) { os << ",NA,NA,NA,NA,NA,NA"; return; }
+    std::sort(values.begin(), values.end());
+    double total = 0;
+    for (double val : values) total += val;
+    os << "," << (total / (double)values.size()) << "," << values.front() << "," << quantile(values, 0.25)
+       << "," << quantile(values, 0.5) << "," << quantile(values, 0.75) << "," << values.back();
+  };
+
+  for (const Treatment & treatment : treatments) {
+    // Each treatment gets its own workers (deme and hardware settings are fixed at construction).
+    emp::vector<emp::Ptr<Experiment>> workers;
+    for (size_t i = 0; i < thread_cnt; ++i) workers.emplace_back(emp::NewPtr<Experiment>(*analysis_config, this, &treatment));
+    std::atomic<size_t> next_seed(0);
+    auto evaluate = [&program, &seeds, &phens, &next_seed, &workers](size_t w) {
+      Experiment & worker = *workers[w];
+      Agent our_hero(worker.LocalizeProgram(program));
+      our_hero.SetID(0);
+      for (size_t seedID = next_seed++; seedID < seeds.size(); seedID = next_seed++) {
+        worker.EvaluateAnalysisTrial(our_hero, seeds[seedID]);
+        phens[seedID] = worker.agent_phen_cache[our_hero.GetID()];
+      }
+    };
+    if (analysis_pool) analysis_pool->Run(workers.size(), evaluate);
+    else evaluate(0);
+    for (auto worker : workers) worker.Delete();
+
+    std::stringstream treatment_stream;
+    treatment_stream << treatment.msg_delay << "," << treatment.fork_on_msg << "," << treatment.deme_width << "," << treatment.deme_height;
+    const std::string treatment_str = treatment_stream.str();
+    size_t consensus_cnt = 0;
+    double total_score = 0;
+    consensus_times.clear();
+    for (size_t seedID = 0; seedID < seeds.size(); ++seedID) {
+      const Phenotype & phen = phens[seedID];
+      eval_ofstream << "\n" << treatment_str << "," << seedID << "," << phen.score << "," << phen.first_full_consensus_time
+                    << "," << phen.total_full_consensus_time << "," << phen.mr_full_consensus_time << "," << phen.max_consensus_size
+                    << "," << phen.valid_vote_cnt << "," << phen.msgs_exchanged;
+      msg_cnts[seedID] = (double)phen.msgs_exchanged;
+      if (phen.total_full_consensus_time) {
+        ++consensus_cnt;
+        consensus_times.emplace_back((double)phen.first_full_consensus_time);
+      }
+      total_score += phen.score;
+    }
+    summary_ofstream << "\n" << treatment_str << "," << seeds.size() << "," << ((double)consensus_cnt / (double)seeds.size())
+                     << "," << (total_score / (double)seeds.size());
+    print_dist(summary_ofstream, consensus_times);
+    print_dist(summary_ofstream, msg_cnts);
+    eval_ofstream.flush();
+    summary_ofstream.flush();
+    std::cout << "Treatment (delay=" << treatment.msg_delay << ", fork=" << treatment.fork_on_msg << ", deme="
+              << treatment.deme_width << "x" << treatment.deme_height << "): consensus rate="
+              << ((double)consensus_cnt / (double)seeds.size()) << ", mean score=" << (total_score / (double)seeds.size()) << std::endl;
+  }
+  eval_ofstream.close();
+  summary_ofstream.close();
+}
+
+/// Evaluate every program in each of the population snapshots (see Snapshot_SingleFile) in
+/// ANALYZE_SNAPSHOT_FPATHS TRIAL_CNT times, writing one row of summary stats per program. A snapshot's
+/// dominant is the program with the best mean score (ties go to the best min score). Seeds are drawn in
+/// program/trial order, so results do not depend on thread count.
+void Experiment::Analysis_Snapshots() {
+  emp::vector<std::string> snapshot_fpaths;
+  emp::slice(ANALYZE_SNAPSHOT_FPATHS, snapshot_fpaths, ',');
+  std::ofstream prog_ofstream("./"+ANALYSIS_OUTPUT_FNAME);
+  prog_ofstream << "snapshot,program,dominant,trials,mean_score,min_score,median_score,max_score,consensus_rate,mean_msgs_sent";
+  const size_t trial_cnt = std::max<size_t>(1, TRIAL_CNT);
+  emp::vector<program_t> programs;
+  emp::vector<int> trial_seeds;
+  emp::vector<double> scores, msg_cnts;
+  emp::vector<size_t> consensus_cnts;
+  for (const std::string & snapshot_fpath : snapshot_fpaths) {
+    if (snapshot_fpath.empty()) continue;
+    if (!program_loader->LoadPopFile(snapshot_fpath, programs)) {
+      std::cout << "Failed to load population snapshot file (" << program_loader->GetError() << "). Exiting..." << std::endl;
+      exit(-1);
+    }
+    if (programs.empty()) {
+      std::cout << "Snapshot " << snapshot_fpath << ": no programs." << std::endl;
+      continue;
+    }
+    trial_seeds.resize(programs.size() * trial_cnt);
+    for (int & seed : trial_seeds) seed = random->GetInt(1, 2000000000);
+    scores.assign(programs.size() * trial_cnt, 0);
+    msg_cnts.assign(programs.size(), 0);
+    consensus_cnts.assign(programs.size(), 0);
+    std::atomic<size_t> next_prog(0);
+    auto evaluate = [&programs, &trial_seeds, &scores, &msg_cnts, &consensus_cnts, &next_prog, trial_cnt](Experiment & evaluator) {
+      for (size_t progID = next_prog++; progID < programs.size(); progID = next_prog++) {
+        Agent our_hero(evaluator.LocalizeProgram(programs[progID]));
+        our_hero.SetID(0);
+        for (size_t tID = 0; tID < trial_cnt; ++tID) {
+          scores[progID * trial_cnt + tID] = evaluator.EvaluateAnalysisTrial(our_hero, trial_seeds[progID * trial_cnt + tID]);
+          const Phenotype & phen = evaluator.agent_phen_cache[our_hero.GetID()];
+          msg_cnts[progID] += (double)phen.msgs_exchanged;
+          if (phen.total_full_consensus_time) ++consensus_cnts[progID];
+        }
+      }
+    };
+    if (analysis_workers.empty()) evaluate(*this);
+    else analysis_pool->Run(analysis_workers.size(), [this, &evaluate](size_t w) { evaluate(*analysis_workers[w]); });
+
+    // Summarize each program's scores (sorted in place) and find the dominant.
+    emp::vector<double> mean_scores(programs.size());
+    size_t dom_id = 0;
+    for (size_t progID = 0; progID < programs.size(); ++progID) {
+      const auto begin = scores.begin() + progID * trial_cnt;
+      std::sort(begin, begin + trial_cnt);
+      double total = 0;
+      for (size_t tID = 0; tID < trial_cnt; ++tID) total += begin[tID];
+      mean_scores[progID] = total / (double)trial_cnt;
+      if (mean_scores[progID] > mean_scores[dom_id] || (mean_scores[progID] == mean_scores[dom_id] && begin[0] > scores[dom_id * trial_cnt])) dom_id = progID;
+    }
+    for (size_t progID = 0; progID < programs.size(); ++progID) {
+      const auto begin = scores.begin() + progID * trial_cnt;
+      prog_ofstream << "\n" << snapshot_fpath << "," << progID << "," << (progID == dom_id) << "," << trial_cnt
+                    << "," << mean_scores[progID] << "," << begin[0] << "," << begin[(trial_cnt - 1) / 2] << "," << begin[trial_cnt - 1]
+                    << "," << ((double)consensus_cnts[progID] / (double)trial_cnt) << "," << (msg_cnts[progID] / (double)trial_cnt);
+    }
+    prog_ofstream.flush();
+    std::cout << "Snapshot " << snapshot_fpath << ": " << programs.size() << " programs; dominant: " << dom_id
+              << " (mean score=" << mean_scores[dom_id] << ", min score=" << scores[dom_id * trial_cnt] << ")" << std::endl;
+  }
+  prog_ofstream.close();
+}
 
 void Experiment::Config_HW() {
   // - Setup the instruction set. -
@@ -952,9 +1693,15 @@ void Experiment::Config_HW() {
 
   // Add experiment-specific instructions.
   // - Orientation instructions
-  inst_lib->AddInst("RotCW", Inst_RotCW, 0, "Rotate clockwise");
-  inst_lib->AddInst("RotCCW", Inst_RotCCW, 0, "Rotate couter-clockwise");
-  inst_lib->AddInst("RandomDir", Inst_RandomDir, 1, "Local memory: Arg1 => RandomUInt([0:4)");
+  inst_lib->AddInst("RotCW", [this](hardware_t & hw, const inst_t & inst) {
+      this->Inst_RotCW(hw, inst);
+    }, 0, "Rotate clockwise");
+  inst_lib->AddInst("RotCCW", [this](hardware_t & hw, const inst_t & inst) {
+      this->Inst_RotCCW(hw, inst);
+    }, 0, "Rotate couter-clockwise");
+  inst_lib->AddInst("RandomDir", [this](hardware_t & hw, const inst_t & inst) {
+      this->Inst_RandomDir(hw, inst);
+    }, 1, "Local memory: Arg1 => RandomUInt([0:NUM_NEIGHBORS)");
   inst_lib->AddInst("GetDir", Inst_GetDir, 0, "WM[ARG1]=CURRENT DIRECTION");
   // - Messaging instructions
   inst_lib->AddInst("SendMsg", Inst_SendMsgFacing, 0, "Send output memory as message event to faced neighbor.", emp::ScopeType::BASIC, 0, {"affinity"});
@@ -966,10 +1713,18 @@ void Experiment::Config_HW() {
 
   // Configure evaluation hardware.
   // Make eval deme.
-  eval_deme = emp::NewPtr<deme_t>(DEME_WIDTH, DEME_HEIGHT, random, inst_lib, event_lib);
+  eval_deme = emp::NewPtr<deme_t>(DEME_WIDTH, DEME_HEIGHT, random, inst_lib, event_lib,
+                                  DEME_UPDATE_MODE, DEME_TILE_WIDTH, DEME_TILE_HEIGHT, DEME_THREADS);
+  Config_Topology();
+  if (DEME_SCHEDULE_METHOD > deme_t::SCHEDULE_METHOD__ROTATION || (DEME_SCHEDULE_METHOD == deme_t::SCHEDULE_METHOD__POOL && !DEME_SCHEDULE_POOL_SIZE)) {
+    std::cout << "Bad deme schedule method/pool size. Exiting..." << std::endl;
+    exit(-1);
+  }
+  eval_deme->SetScheduleMethod(DEME_SCHEDULE_METHOD, DEME_SCHEDULE_POOL_SIZE);
   eval_deme->SetHardwareMinBindThresh(SGP_HW_MIN_BIND_THRESH);
   eval_deme->SetHardwareMaxCores(SGP_HW_MAX_CORES);
   eval_deme->SetHardwareMaxCallDepth(SGP_HW_MAX_CALL_DEPTH);
+  eval_deme->SetFastReset(SGP_HW_FAST_RESET);
 
   eval_deme->OnHardwareReset([this](hardware_t & hw) {
     hw.SetTrait(TRAIT_ID__UID, 0);        // Reset traits. 
@@ -987,32 +1742,46 @@ void Experiment::Config_HW() {
     event_lib->AddEvent("BroadcastMessage", HandleEvent__Message_NonForking, "Broadcast message event.");
   }
 
+  // In synchronous deme update mode, messages are posted to the deme and delivered (with the
+  // treatment-specific delivery function) at the end of each deme update.
+  const bool sync_deme = DEME_UPDATE_MODE == deme_t::UPDATE_MODE__SYNC;
+  if (sync_deme) {
+    event_lib->RegisterDispatchFun("SendMessage", [this](hardware_t & hw, const event_t & event) {
+      this->Sync__DispatchMessage_Send(hw, event);
+    });
+    event_lib->RegisterDispatchFun("BroadcastMessage", [this](hardware_t &hw, const event_t &event) {
+      this->Sync__DispatchMessage_Broadcast(hw, event);
+    });
+  }
+
   if (SGP_HW_EVENT_DRIVEN) { // Hardware is event-driven.
     if (SGP_HW_ED_MSG_DELAY) {
       // Configure dispatchers
-      eval_deme->OnHardwareAdvance([this](hardware_t & hw) {
-        const size_t hw_id = hw.GetTrait(TRAIT_ID__DEME_ID);
-        DoDelayDeliver(hw_id);
-      });
-      event_lib->RegisterDispatchFun("SendMessage", [this](hardware_t & hw, const event_t & event) {
-        this->EventDriven_Delay__DispatchMessage_Send(hw, event);
-      });
-      event_lib->RegisterDispatchFun("BroadcastMessage", [this](hardware_t &hw, const event_t &event) {
-        this->EventDriven_Delay__DispatchMessage_Broadcast(hw, event);
-      });
+      if (sync_deme) {
+        eval_deme->SetDeliverFun([this](size_t id, const event_t & event) { this->DelayDelivery(id, event); });
+      } else {
+        event_lib->RegisterDispatchFun("SendMessage", [this](hardware_t & hw, const event_t & event) {
+          this->EventDriven_Delay__DispatchMessage_Send(hw, event);
+        });
+        event_lib->RegisterDispatchFun("BroadcastMessage", [this](hardware_t &hw, const event_t &event) {
+          this->EventDriven_Delay__DispatchMessage_Broadcast(hw, event);
+        });
+      }
       // Configure inboxes.
       inboxes.resize(DEME_SIZE);
-      eval_deme->OnHardwareReset([this](hardware_t & hw) {
-        this->ResetInbox(hw.GetTrait(TRAIT_ID__DEME_ID));
-      });
+      eval_deme->OnDemeReset([this]() { this->ResetInboxes(); });
     } else {
       // Configure dispatchers
-      event_lib->RegisterDispatchFun("SendMessage", [this](hardware_t & hw, const event_t & event) {
-        this->EventDriven__DispatchMessage_Send(hw, event);
-      });
-      event_lib->RegisterDispatchFun("BroadcastMessage", [this](hardware_t &hw, const event_t &event) {
-        this->EventDriven__DispatchMessage_Broadcast(hw, event);
-      });
+      if (sync_deme) {
+        eval_deme->SetDeliverFun([this](size_t id, const event_t & event) { eval_deme->GetHardware(id).QueueEvent(event); });
+      } else {
+        event_lib->RegisterDispatchFun("SendMessage", [this](hardware_t & hw, const event_t & event) {
+          this->EventDriven__DispatchMessage_Send(hw, event);
+        });
+        event_lib->RegisterDispatchFun("BroadcastMessage", [this](hardware_t &hw, const event_t &event) {
+          this->EventDriven__DispatchMessage_Broadcast(hw, event);
+        });
+      }
     }
   } else { // Hardware is imperative.
     // Add retrieve message instruction to instruction set.
@@ -1020,24 +1789,107 @@ void Experiment::Config_HW() {
         this->Inst_RetrieveMsg(hw, inst);
       }, 0, "Retrieve a message from message inbox.");
     // Configure dispatchers
-    event_lib->RegisterDispatchFun("SendMessage", [this](hardware_t & hw, const event_t & event) {
-      this->Imperative__DispatchMessage_Send(hw, event);
-    });
-    event_lib->RegisterDispatchFun("BroadcastMessage", [this](hardware_t &hw, const event_t &event) {
-      this->Imperative__DispatchMessage_Broadcast(hw, event);
-    });
+    if (sync_deme) {
+      eval_deme->SetDeliverFun([this](size_t id, const event_t & event) { this->DeliverToInbox(id, event); });
+    } else {
+      event_lib->RegisterDispatchFun("SendMessage", [this](hardware_t & hw, const event_t & event) {
+        this->Imperative__DispatchMessage_Send(hw, event);
+      });
+      event_lib->RegisterDispatchFun("BroadcastMessage", [this](hardware_t &hw, const event_t &event) {
+        this->Imperative__DispatchMessage_Broadcast(hw, event);
+      });
+    }
     // Configure inboxes.
     inboxes.resize(DEME_SIZE);
-    eval_deme->OnHardwareReset([this](hardware_t & hw) {
-      this->ResetInbox(hw.GetTrait(TRAIT_ID__DEME_ID));
+    eval_deme->OnDemeReset([this]() { this->ResetInboxes(); });
+  }
+
+  // Configure per-hardware advance pipeline.
+  const bool delay_msgs = SGP_HW_EVENT_DRIVEN && SGP_HW_ED_MSG_DELAY;
+  if (sync_deme) {
+    // Hardware may be advanced on worker threads; tally votes and count messages once all are done.
+    eval_deme->OnDemePostAdvance([this]() {
+      for (size_t i = 0; i < eval_deme->GetSize(); ++i) {
+        eval_deme->TallyVote((uint32_t)eval_deme->GetHardware(i).GetTrait(TRAIT_ID__OPINION));
+      }
+      agent_phen_cache[eval_deme->GetPhenID()].msgs_exchanged += eval_deme->GetStepMsgCnt();
     });
+    if (delay_msgs) SetDemePipeline(DeliverStage__Delayed{this}, TallyStage__None());
+    else SetDemePipeline(DeliverStage__None(), TallyStage__None());
+  } else {
+    if (delay_msgs) SetDemePipeline(DeliverStage__Delayed{this}, TallyStage__Immediate{this});
+    else SetDemePipeline(DeliverStage__None(), TallyStage__Immediate{this});
   }
+  Config_Dispatch();
+  program_loader = emp::NewPtr<program_loader_t>(inst_lib);
+}
 
-  eval_deme->OnHardwareAdvance([this](hardware_t & hw) {
-    hw.SingleProcess();
-    uint32_t vote = (uint32_t)hw.GetTrait(TRAIT_ID__OPINION);
-    eval_deme->TallyVote(vote);
-  });
+/// Configure fast instruction dispatch (if SGP_HW_FAST_DISPATCH). Must be called after all
+/// instructions have been added to the instruction library.
+void Experiment::Config_Dispatch() {
+  if (!SGP_HW_FAST_DISPATCH) return;
+  inst_dispatch = emp::NewPtr<dispatch_table_t>();
+  inst_dispatch->BindDefaults();
+  inst_dispatch->BindFun<Inst_Fork>("Fork");
+  inst_dispatch->BindMember<Experiment, &Experiment::Inst_RotCW>("RotCW", *this);
+  inst_dispatch->BindMember<Experiment, &Experiment::Inst_RotCCW>("RotCCW", *this);
+  inst_dispatch->BindMember<Experiment, &Experiment::Inst_RandomDir>("RandomDir", *this);
+  inst_dispatch->BindFun<Inst_GetDir>("GetDir");
+  inst_dispatch->BindFun<Inst_SendMsgFacing>("SendMsg");
+  inst_dispatch->BindFun<Inst_BroadcastMsg>("BroadcastMsg");
+  inst_dispatch->BindMember<Experiment, &Experiment::Inst_RetrieveMsg>("RetrieveMsg", *this);
+  inst_dispatch->BindFun<Inst_GetUID>("GetUID");
+  inst_dispatch->BindFun<Inst_GetOpinion>("GetOpinion");
+  inst_dispatch->BindFun<Inst_SetOpinion>("SetOpinion");
+  inst_dispatch->Lower(inst_lib);
+  eval_deme->SetHardwareDispatchTable(inst_dispatch);
+}
+
+/// Configure the deme's neighbor network (von Neumann torus unless configured otherwise).
+void Experiment::Config_Topology() {
+  const size_t degree = DEME_TOPOLOGY_DEGREE;
+  if ((DEME_TOPOLOGY == TOPOLOGY_ID__RING || DEME_TOPOLOGY == TOPOLOGY_ID__SMALL_WORLD)
+      && (degree == 0 || degree % 2 || degree >= DEME_SIZE)) {
+    std::cout << "Ring/small-world DEME_TOPOLOGY_DEGREE must be even, non-zero, and less than deme size. Exiting..." << std::endl;
+    exit(-1);
+  }
+  if (DEME_TOPOLOGY == TOPOLOGY_ID__RANDOM_REGULAR && (degree == 0 || degree >= DEME_SIZE || (degree * DEME_SIZE) % 2)) {
+    std::cout << "No random regular graph with degree " << degree << " and " << DEME_SIZE << " nodes. Exiting..." << std::endl;
+    exit(-1);
+  }
+  switch (DEME_TOPOLOGY) {
+    case TOPOLOGY_ID__VON_NEUMANN:
+      break; // Deme default.
+    case TOPOLOGY_ID__MOORE:
+      eval_deme->SetTopology(DemeTopology::MooreTorus(DEME_WIDTH, DEME_HEIGHT));
+      break;
+    case TOPOLOGY_ID__RING:
+      eval_deme->SetTopology(DemeTopology::Ring(DEME_SIZE, degree));
+      break;
+    case TOPOLOGY_ID__RANDOM_REGULAR:
+      eval_deme->SetTopology(DemeTopology::RandomRegular(DEME_SIZE, degree, *random));
+      break;
+    case TOPOLOGY_ID__SMALL_WORLD:
+      eval_deme->SetTopology(DemeTopology::SmallWorld(DEME_SIZE, degree, DEME_TOPOLOGY_REWIRE_PROB, *random));
+      break;
+    case TOPOLOGY_ID__EDGE_LIST: {
+      std::ifstream topo_fstream(DEME_TOPOLOGY_FPATH);
+      if (!topo_fstream.is_open()) {
+        std::cout << "Failed to open deme topology file(" << DEME_TOPOLOGY_FPATH << "). Exiting..." << std::endl;
+        exit(-1);
+      }
+      DemeTopology topo;
+      if (!DemeTopology::LoadEdgeList(topo_fstream, DEME_SIZE, topo, std::cout)) {
+        std::cout << "Failed to load deme topology file(" << DEME_TOPOLOGY_FPATH << "). Exiting..." << std::endl;
+        exit(-1);
+      }
+      eval_deme->SetTopology(topo);
+      break;
+    }
+    default:
+      std::cout << "Unrecognized deme topology (" << DEME_TOPOLOGY << "). Exiting..." << std::endl;
+      exit(-1);
+  }
 }
 
 /// Mutation rules:
@@ -1224,6 +2076,7 @@ size_t Experiment::Mutate(Agent &agent, emp::Random &rnd) {
       program[fID] = new_fun;
     }
   }
+  if (mut_cnt) agent.shared_program.reset();
   return mut_cnt;
 }
 
@@ -0,0 +1,68 @@
+#ifndef FAST_RANDOM_H
+#define FAST_RANDOM_H
+
+#include <cstdint>
+#include <utility>
+#include "base/vector.h"
+
+/// Small, fast pseudo-random number generator (xoroshiro128+, seeded via splitmix64) for high-volume,
+/// low-stakes draws such as per-update schedule shuffles. Bounded draws use Lemire's multiply-shift
+/// method with rejection, so they are unbiased.
+/// NOTE: Not a replacement for emp::Random; it produces a different stream and lacks its distributions.
+class FastRandom {
+protected:
+  uint64_t s0;
+  uint64_t s1;
+
+  static uint64_t SplitMix64(uint64_t & x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  static uint64_t RotL(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+  FastRandom(uint64_t seed=1) { ResetSeed(seed); }
+
+  void ResetSeed(uint64_t seed) {
+    s0 = SplitMix64(seed);
+    s1 = SplitMix64(seed);
+  }
+
+  uint64_t Next64() {
+    const uint64_t r = s0 + s1;
+    s1 ^= s0;
+    s0 = RotL(s0, 24) ^ s1 ^ (s1 << 16);
+    s1 = RotL(s1, 37);
+    return r;
+  }
+
+  /// Upper 32 bits (the low bits of xoroshiro128+ are weak).
+  uint32_t Next32() { return (uint32_t)(Next64() >> 32); }
+
+  /// Uniform integer in [0:bound).
+  uint32_t GetUInt(uint32_t bound) {
+    uint64_t m = (uint64_t)Next32() * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+      const uint32_t threshold = (uint32_t)(-bound) % bound;
+      while (low < threshold) {
+        m = (uint64_t)Next32() * bound;
+        low = (uint32_t)m;
+      }
+    }
+    return (uint32_t)(m >> 32);
+  }
+
+  /// Fisher-Yates shuffle.
+  template <typename T>
+  void Shuffle(emp::vector<T> & v) {
+    for (size_t i = v.size(); i > 1; --i) {
+      std::swap(v[i-1], v[GetUInt((uint32_t)i)]);
+    }
+  }
+};
+
+#endif
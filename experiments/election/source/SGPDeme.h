@@ -4,6 +4,7 @@
 #include <iostream>
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include "base/Ptr.h"
 #include "base/vector.h"
 #include "control/Signal.h"
@@ -11,9 +12,12 @@
 #include "tools/Random.h"
 #include "tools/random_utils.h"
 
-//TODO:
-// [ ] Signals
-// [ ] Test neighbor network
+#include "FastEventDrivenGP.h"
+
+#include "DemeTopology.h"
+#include "FastRandom.h"
+#include "WorkerPool.h"
+#include "MemoryUsage.h"
 
 class SGPDeme {
 public:
@@ -22,10 +26,35 @@ public:
   static constexpr size_t DIR_LEFT = 1;
   static constexpr size_t DIR_DOWN = 2;
   static constexpr size_t DIR_RIGHT = 3;
-  static constexpr size_t NUM_DIRS = 4;
+  static constexpr size_t NUM_DIRS = 4;     ///< Directions in default (von Neumann torus) topology.
+
+  static constexpr size_t UPDATE_MODE__ASYNC = 0;   ///< Hardware advanced one at a time in random order (used in paper).
+  static constexpr size_t UPDATE_MODE__SYNC = 1;    ///< Hardware advanced in parallel tiles; messages exchanged between steps.
+
+  /// Asynchronous-mode schedule methods (order in which hardware gets CPU cycles each update):
+  /// - SHUFFLE: full emp::Shuffle with the deme's random number generator (N draws per update; used in paper).
+  ///   Every update's order is uniform over all N! permutations and independent of every other update.
+  /// - POOL: one of POOL_SIZE permutations (drawn uniformly once, up front) is picked uniformly at random
+  ///   each update (1 draw per update). Each update's order is still marginally uniform over all permutations,
+  ///   but orders repeat, and all evaluations share the same pool, so updates are not independent.
+  /// - FAST_SHUFFLE: full Fisher-Yates shuffle with a dedicated FastRandom generator. Same distribution as
+  ///   SHUFFLE (up to generator quality), just cheaper draws; a different stream than SHUFFLE.
+  /// - ROTATION: a base order is shuffled once per evaluation (on reset); each update uses a uniformly random
+  ///   cyclic rotation of it (1 draw per update). Each agent's position is uniform, but the cyclic order of
+  ///   agents is fixed within an evaluation (only N distinct orders), so precedence between particular pairs
+  ///   of agents is strongly correlated across updates.
+  /// Non-default methods draw only from the dedicated generator, leaving the deme's generator untouched.
+  static constexpr size_t SCHEDULE_METHOD__SHUFFLE = 0;
+  static constexpr size_t SCHEDULE_METHOD__POOL = 1;
+  static constexpr size_t SCHEDULE_METHOD__FAST_SHUFFLE = 2;
+  static constexpr size_t SCHEDULE_METHOD__ROTATION = 3;
 
   using hardware_t = emp::EventDrivenGP_AW<TAG_WIDTH>;
-  using grid_t = emp::vector<hardware_t>;
+  using fast_hardware_t = FastEventDrivenGP_AW<TAG_WIDTH>;   ///< Type of hardware in grid.
+  using grid_t = emp::vector<fast_hardware_t>;
+  using dispatch_table_t = fast_hardware_t::dispatch_table_t;
+  using shared_program_t = fast_hardware_t::shared_program_t;
+  using shared_program_ptr_t = fast_hardware_t::shared_program_ptr_t;
   using program_t = hardware_t::Program;
   using state_t = hardware_t::State;
   using inst_t = hardware_t::inst_t;
@@ -35,84 +64,183 @@ public:
   using memory_t = hardware_t::memory_t;
   using tag_t = hardware_t::affinity_t;
 
+  using deliver_fun_t = std::function<void(size_t, const event_t &)>;
+
 protected:
+  /// Message posted (in synchronous mode) during a deme update; delivered at end of the update.
+  struct Message {
+    size_t dest_id;
+    event_t event;
+    Message(size_t _dest, const event_t & _event) : dest_id(_dest), event(_event) { ; }
+  };
+
+  /// Rectangular block of the deme grid advanced as a unit in synchronous mode.
+  struct Tile {
+    emp::vector<size_t> members;            ///< Loc IDs in this tile (row-major order).
+    emp::Ptr<emp::Random> random;           ///< Tile-local random number generator (shared by hardware in tile).
+    emp::vector<emp::vector<Message>> outbox; ///< Messages posted by this tile, bucketed by destination tile.
+    size_t msg_cnt;                         ///< Messages posted by this tile during current deme update.
+    Tile() : members(), random(nullptr), outbox(), msg_cnt(0) { ; }
+  };
+
   grid_t grid;
   size_t width;
   size_t height;
+  size_t update_mode;
   emp::vector<size_t> schedule; ///< Utility vector to store order to give each hardware in the deme a CPU cycle on a single deme update.
-  emp::vector<size_t> neighbor_lookup;
+  size_t schedule_method;
+  emp::vector<size_t> schedule_pool;  ///< POOL: pool size x deme size permutations, stored flat.
+  emp::vector<size_t> schedule_base;  ///< ROTATION: order rotated each update.
+  FastRandom schedule_random;         ///< Used by non-default schedule methods.
+  DemeTopology topology;        ///< Neighbor network (defaults to von Neumann torus over the grid).
   emp::Ptr<emp::Random> random;
+  bool fast_reset;              ///< Restore hardware from post-reset snapshots instead of resetting it?
 
   emp::Ptr<inst_lib_t> inst_lib;
   emp::Ptr<event_lib_t> event_lib;
-  program_t deme_program;
+  shared_program_ptr_t deme_program;            ///< Referenced by all hardware in grid.
+  emp::Ptr<const dispatch_table_t> dispatch_table;
+
+  // Synchronous update mode.
+  emp::vector<Tile> tiles;
+  emp::vector<size_t> tile_lookup;      ///< Loc ID => tile ID.
+  emp::Ptr<WorkerPool> workers;
+  deliver_fun_t deliver_fun;            ///< Used to hand a message to its destination hardware.
 
   // Signals!
   // - Reset hardware.
   emp::Signal<void(hardware_t &)> on_hardware_reset_sig;
+  emp::Signal<void(void)> on_deme_reset_sig;
   emp::Signal<void(hardware_t &)> on_hardware_advance_sig;
   emp::Signal<void(void)> on_deme_single_advance_sig;
+  emp::Signal<void(void)> on_deme_post_advance_sig;
 
-
-  void BuildNeighbors() {
-    neighbor_lookup.resize(grid.size()*NUM_DIRS);
-    for (size_t i = 0; i < grid.size(); ++i) {
-      for (size_t d = 0; d < NUM_DIRS; ++d) {
-        neighbor_lookup[GetNeighborIndex(i, d)] = CalcNeighbor(i, d);
-      }
-    }
-  }
-
-  size_t CalcNeighbor(size_t id, size_t dir) const {
-    int facing_x = (int)GetLocX(id);
-    int facing_y = (int)GetLocY(id);
-    switch(dir) {
-      case DIR_UP:    facing_y = emp::Mod(facing_y - 1, (int)height); break;
-      case DIR_LEFT:  facing_x = emp::Mod(facing_x - 1, (int)width);  break;
-      case DIR_RIGHT: facing_x = emp::Mod(facing_x + 1, (int)width);  break;
-      case DIR_DOWN:  facing_y = emp::Mod(facing_y + 1, (int)height); break;
-      default:
-        emp_assert(false, "Bad direction!"); // TODO: put an assert here.
-        break;
-    }
-    return GetID(facing_x, facing_y);
-  }
-
-  size_t GetNeighborIndex(size_t id, size_t dir) const {
-    return (id*NUM_DIRS) + dir;
-  }
+  void BuildTiles(size_t tile_w, size_t tile_h);
+  const size_t * UpdateSchedule();
+  void DeliverPosted();
 
 public:
-  SGPDeme(size_t _w, size_t _h, emp::Ptr<emp::Random> _rnd, emp::Ptr<inst_lib_t> _ilib, emp::Ptr<event_lib_t> _elib)
-    : grid(), width(_w), height(_h), schedule(width*height), neighbor_lookup(),
-      random(_rnd), inst_lib(_ilib), event_lib(_elib), deme_program(inst_lib)
+  /// Construct a deme.
+  /// - In synchronous update mode, the grid is split into _tile_w x _tile_h tiles (0 => whole row/column),
+  ///   and tiles are advanced on up to _threads threads (0 => one per hardware thread).
+  SGPDeme(size_t _w, size_t _h, emp::Ptr<emp::Random> _rnd, emp::Ptr<inst_lib_t> _ilib, emp::Ptr<event_lib_t> _elib,
+          size_t _update_mode=UPDATE_MODE__ASYNC, size_t _tile_w=0, size_t _tile_h=0, size_t _threads=1)
+    : grid(), width(_w), height(_h), update_mode(_update_mode), schedule(width*height),
+      schedule_method(SCHEDULE_METHOD__SHUFFLE), schedule_pool(), schedule_base(), schedule_random(),
+      topology(DemeTopology::VonNeumannTorus(width, height)),
+      random(_rnd), fast_reset(false), inst_lib(_ilib), event_lib(_elib), deme_program(), dispatch_table(nullptr),
+      tiles(), tile_lookup(), workers(nullptr), deliver_fun()
   {
+    emp_assert(update_mode == UPDATE_MODE__ASYNC || update_mode == UPDATE_MODE__SYNC, "Bad deme update mode!");
+    if (update_mode == UPDATE_MODE__SYNC) {
+      BuildTiles(_tile_w, _tile_h);
+      if (_threads == 0) _threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+      #if defined(EMP_TRACK_MEM) || defined(EMP_MEM_TRACK)
+      _threads = 1; // Memory tracking is not thread safe.
+      #endif
+      workers = emp::NewPtr<WorkerPool>(std::min(_threads, tiles.size()));
+    }
     // Fill out the grid with hardware.
     for (size_t i = 0; i < width*height; ++i) {
-      grid.emplace_back(inst_lib, event_lib, random);
+      if (update_mode == UPDATE_MODE__SYNC) grid.emplace_back(inst_lib, event_lib, tiles[tile_lookup[i]].random);
+      else grid.emplace_back(inst_lib, event_lib, random);
       schedule[i] = i;
     }
-    BuildNeighbors(); ///< Build neighbor lookup table.
   }
 
   ~SGPDeme() {
     grid.clear();
+    if (workers) workers.Delete();
+    for (size_t t = 0; t < tiles.size(); ++t) tiles[t].random.Delete();
   }
 
+  SGPDeme(const SGPDeme &) = delete;
+  SGPDeme & operator=(const SGPDeme &) = delete;
+
   /// Reset the deme.
+  /// With fast reset on, each hardware unit is reset (and OnHardwareReset actions run) only the first time;
+  /// the result is saved and restored by later resets. OnHardwareReset actions must therefore leave every
+  /// hardware unit in the same state on every reset. Deme-wide reset work belongs in OnDemeReset actions,
+  /// which run on every reset.
+  /// In SGP_HW_ARENA builds, all hardware (and posted messages) release their storage before any hardware
+  /// resets its arena, since events one unit queued on another were drawn from the sender's arena.
   void ResetHardware() {
-    deme_program.Clear();
+    deme_program.reset();
+    if (TRIAL_ARENA_ENABLED) {
+      for (fast_hardware_t & hw : grid) hw.ReleaseRunState();
+      for (Tile & tile : tiles) {
+        for (emp::vector<Message> & box : tile.outbox) emp::vector<Message>().swap(box);
+      }
+    }
     for (size_t i = 0; i < grid.size(); ++i) {
       schedule[i] = i;
+      if (fast_reset && grid[i].HasResetState()) {
+        grid[i].RestoreResetState();
+        continue;
+      }
       grid[i].ResetHardware();
-      on_hardware_reset_sig.Trigger(grid[i]);
+      {
+        auto arena_scope = grid[i].ArenaScope();
+        on_hardware_reset_sig.Trigger(grid[i]);
+      }
+      if (fast_reset) grid[i].SaveResetState();
+    }
+    on_deme_reset_sig.Trigger();
+    if (schedule_method == SCHEDULE_METHOD__ROTATION) schedule_random.Shuffle(schedule_base);
+    for (Tile & tile : tiles) {
+      for (emp::vector<Message> & box : tile.outbox) box.clear();
+      tile.msg_cnt = 0;
     }
   }
 
-  const program_t & GetProgram() const { return deme_program; }
+  const program_t & GetProgram() const { emp_assert(deme_program); return deme_program->GetProgram(); }
+  shared_program_ptr_t GetSharedProgram() const { return deme_program; }
   size_t GetWidth() const { return width; }
   size_t GetHeight() const { return height; }
   size_t GetSize() const { return grid.size(); }
+  size_t GetUpdateMode() const { return update_mode; }
+  size_t GetScheduleMethod() const { return schedule_method; }
+  bool GetFastReset() const { return fast_reset; }
+  size_t GetTileCnt() const { return tiles.size(); }
+  size_t GetThreadCnt() const { return workers ? workers->GetSize() : 1; }
+
+  /// Synchronous mode: how many messages were posted during the most recent deme update?
+  size_t GetStepMsgCnt() const {
+    size_t cnt = 0;
+    for (const Tile & tile : tiles) cnt += tile.msg_cnt;
+    return cnt;
+  }
+
+  /// Heap bytes held by the deme: hardware, the deme program, schedules, and posted messages.
+  size_t GetMemoryBytes() const {
+    using namespace memory_usage;
+    size_t bytes = VectorBytes(grid) + VectorBytes(schedule) + VectorBytes(schedule_pool) + VectorBytes(schedule_base)
+                   + VectorBytes(tiles) + VectorBytes(tile_lookup);
+    for (const fast_hardware_t & hw : grid) bytes += hw.GetMemoryBytes();
+    if (deme_program) bytes += sizeof(shared_program_t) + deme_program->GetMemoryBytes();
+    for (const Tile & tile : tiles) {
+      bytes += VectorBytes(tile.members) + VectorBytes(tile.outbox);
+      for (const emp::vector<Message> & box : tile.outbox) {
+        bytes += VectorBytes(box);
+        for (const Message & msg : box) bytes += EventBytes(msg.event);
+      }
+    }
+    return bytes;
+  }
+
+  /// Set function used to deliver posted messages (synchronous mode).
+  void SetDeliverFun(const deliver_fun_t & fun) { deliver_fun = fun; }
+
+  /// Send event from hardware at src_id to hardware at dest_id.
+  /// - Asynchronous mode: delivered immediately.
+  /// - Synchronous mode: buffered in the source tile's outbox and delivered once every tile has advanced.
+  /// Safe to call from hardware being advanced on a worker thread (each tile only touches its own outbox).
+  void PostMessage(size_t src_id, size_t dest_id, const event_t & event) {
+    if (update_mode == UPDATE_MODE__ASYNC) { deliver_fun(dest_id, event); return; }
+    Tile & tile = tiles[tile_lookup[src_id]];
+    tile.outbox[tile_lookup[dest_id]].emplace_back(dest_id, event);
+    ++tile.msg_cnt;
+  }
 
   /// Get x location in deme grid given hardware loc ID.
   size_t GetLocX(size_t id) const { return id % width; }
@@ -123,31 +251,66 @@ public:
   /// Get loc ID of hardware given an x, y position.
   size_t GetID(size_t x, size_t y) const { return (y * width) + x; }
 
+  const DemeTopology & GetTopology() const { return topology; }
+
+  /// Replace the neighbor network. Must cover every hardware unit, and every unit needs a neighbor.
+  void SetTopology(const DemeTopology & _topo) {
+    emp_assert(_topo.GetSize() == grid.size());
+    topology = _topo;
+  }
+
+  /// How many neighbors (i.e., directions) does hardware at id have?
+  size_t GetNeighborCnt(size_t id) const { return topology.GetDegree(id); }
+
+  /// Get neighbor of hardware at id in direction dir (directions are taken modulo neighbor count).
   size_t GetNeighborID(size_t id, size_t dir) const {
-    // TODO: asserts!
-    return neighbor_lookup[GetNeighborIndex(id, dir)];
+    emp_assert(id < grid.size());
+    return topology.GetNeighbor(id, dir % topology.GetDegree(id));
   }
 
-  hardware_t & GetNeighbor(size_t id, size_t dir) { return GetHardware(neighbor_lookup[GetNeighborIndex(id, dir)]); }
-  hardware_t & GetHardware(size_t id) { return grid[id]; }
+  fast_hardware_t & GetNeighbor(size_t id, size_t dir) { return GetHardware(GetNeighborID(id, dir)); }
+  fast_hardware_t & GetHardware(size_t id) { return grid[id]; }
 
-  emp::SignalKey OnHardwareReset(const std::function<void(hardware_t &)> & fun) { return on_hardware_reset_sig.AddAction(fun); }
+  emp::SignalKey OnHardwareReset(const std::function<void(hardware_t &)> & fun) {
+    for (size_t i = 0; i < grid.size(); ++i) grid[i].ClearResetState(); // Saved states are now stale.
+    return on_hardware_reset_sig.AddAction(fun);
+  }
+  /// Triggered at the end of every deme reset.
+  emp::SignalKey OnDemeReset(const std::function<void(void)> & fun) { return on_deme_reset_sig.AddAction(fun); }
   emp::SignalKey OnHardwareAdvance(const std::function<void(hardware_t &)> & fun) { return on_hardware_advance_sig.AddAction(fun); }
   emp::SignalKey OnDemeAdvance(const std::function<void(void)> & fun) { return on_deme_single_advance_sig.AddAction(fun); }
+  /// Triggered at the end of every deme update (after all hardware advanced and posted messages delivered).
+  emp::SignalKey OnDemePostAdvance(const std::function<void(void)> & fun) { return on_deme_post_advance_sig.AddAction(fun); }
 
 
   void SetProgram(const program_t & _germ);
+  void SetProgram(shared_program_ptr_t _germ);
+  void SetScheduleMethod(size_t method, size_t pool_size=0);
   void SetHardwareMaxCores(size_t max_cores);
   void SetHardwareMaxCallDepth(size_t max_depth);
   void SetHardwareMinBindThresh(double threshold);
+  void SetFastReset(bool fast);
+  void SetHardwareDispatchTable(emp::Ptr<const dispatch_table_t> table);
 
   void Advance(size_t i = 1) { for (size_t t = 0; t < i; ++t) SingleAdvance(); }
   void SingleAdvance();
 
+  /// Advance deme, giving each hardware (fast_hardware_t) a CPU cycle via pipeline(hw) (a callable fixed at compile time)
+  /// instead of triggering OnHardwareAdvance actions. Deme-level signals are still triggered.
+  /// In synchronous mode, pipeline is called concurrently from worker threads.
+  template <typename PIPELINE>
+  void SingleAdvance(const PIPELINE & pipeline);
+
   void PrintState(std::ostream & os=std::cout);
 };
 
 void SGPDeme::SetProgram(const program_t & _germ) {
+  SetProgram(std::make_shared<const shared_program_t>(_germ, dispatch_table));
+}
+
+/// Set deme program. All hardware in the grid reference the same (immutable) program and its derived
+/// data (e.g., decoded form), instead of each holding its own copy.
+void SGPDeme::SetProgram(shared_program_ptr_t _germ) {
   ResetHardware();                              // Reset deme hardware.
   deme_program = _germ;
   for (size_t i = 0; i < grid.size(); ++i) {
@@ -177,13 +340,127 @@ void SGPDeme::SetHardwareMinBindThresh(double threshold) {
   }
 }
 
+/// Turn fast (snapshot-restoring) deme resets on/off (see ResetHardware).
+void SGPDeme::SetFastReset(bool fast) {
+  fast_reset = fast;
+  for (size_t i = 0; i < grid.size(); ++i) grid[i].ClearResetState();
+}
+
+/// Hardware configuration option.
+/// Execute instructions on all hardware units in this deme through given dispatch table (nullptr => inst lib).
+void SGPDeme::SetHardwareDispatchTable(emp::Ptr<const dispatch_table_t> table) {
+  dispatch_table = table;
+  for (size_t i = 0; i < grid.size(); ++i) {
+    grid[i].SetDispatchTable(table);
+  }
+}
+
+/// Set how the asynchronous update schedule is randomized (see SCHEDULE_METHOD__*).
+/// Seeds the dedicated schedule generator from the deme's generator (for non-default methods only).
+void SGPDeme::SetScheduleMethod(size_t method, size_t pool_size) {
+  emp_assert(method <= SCHEDULE_METHOD__ROTATION, "Bad schedule method!");
+  schedule_method = method;
+  schedule_pool.clear();
+  schedule_base.clear();
+  if (method == SCHEDULE_METHOD__SHUFFLE) return;
+  schedule_random.ResetSeed(random->GetUInt(1, 2000000000));
+  const size_t n = grid.size();
+  emp::vector<size_t> perm(n);
+  for (size_t i = 0; i < n; ++i) perm[i] = i;
+  if (method == SCHEDULE_METHOD__POOL) {
+    emp_assert(pool_size > 0);
+    schedule_pool.reserve(pool_size * n);
+    for (size_t p = 0; p < pool_size; ++p) {
+      schedule_random.Shuffle(perm);
+      schedule_pool.insert(schedule_pool.end(), perm.begin(), perm.end());
+    }
+  } else if (method == SCHEDULE_METHOD__ROTATION) {
+    schedule_base = perm;
+    schedule_random.Shuffle(schedule_base);
+  }
+}
+
+/// Randomize the order in which hardware will be advanced this update; returns the order.
+const size_t * SGPDeme::UpdateSchedule() {
+  switch (schedule_method) {
+    case SCHEDULE_METHOD__POOL: {
+      const size_t pool_size = schedule_pool.size() / grid.size();
+      return schedule_pool.data() + schedule_random.GetUInt((uint32_t)pool_size) * grid.size();
+    }
+    case SCHEDULE_METHOD__FAST_SHUFFLE:
+      schedule_random.Shuffle(schedule);
+      return schedule.data();
+    case SCHEDULE_METHOD__ROTATION: {
+      const size_t offset = schedule_random.GetUInt((uint32_t)grid.size());
+      std::copy(schedule_base.begin() + offset, schedule_base.end(), schedule.begin());
+      std::copy(schedule_base.begin(), schedule_base.begin() + offset, schedule.end() - offset);
+      return schedule.data();
+    }
+    default:
+      emp::Shuffle(*random, schedule); // Shuffle the schedule.
+      return schedule.data();
+  }
+}
+
+/// Split grid into tiles (row-major over tiles; members row-major within each tile) and seed
+/// tile-local random number generators from the deme's random number generator.
+void SGPDeme::BuildTiles(size_t tile_w, size_t tile_h) {
+  if (tile_w == 0 || tile_w > width) tile_w = width;
+  if (tile_h == 0 || tile_h > height) tile_h = height;
+  const size_t tiles_x = (width + tile_w - 1) / tile_w;
+  const size_t tiles_y = (height + tile_h - 1) / tile_h;
+  tiles.resize(tiles_x * tiles_y);
+  tile_lookup.resize(width * height);
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      const size_t tile_id = (y / tile_h) * tiles_x + (x / tile_w);
+      tile_lookup[GetID(x, y)] = tile_id;
+      tiles[tile_id].members.emplace_back(GetID(x, y));
+    }
+  }
+  for (Tile & tile : tiles) {
+    tile.random = emp::NewPtr<emp::Random>((int)random->GetUInt(1, 2000000000));
+    tile.outbox.resize(tiles.size());
+  }
+}
+
 void SGPDeme::SingleAdvance() {
-  emp::Shuffle(*random, schedule); // Shuffle the schedule.
-  on_deme_single_advance_sig.Trigger();
-  // Distribute CPU cycles.
-  for (size_t i = 0; i < schedule.size(); ++i) {
-    on_hardware_advance_sig.Trigger(grid[schedule[i]]);
+  SingleAdvance([this](hardware_t & hw) { on_hardware_advance_sig.Trigger(hw); });
+}
+
+/// Asynchronous mode: give each hardware a CPU cycle, one at a time, in a random order.
+/// Synchronous mode: give each hardware a CPU cycle, advancing tiles in parallel; then deliver
+/// messages posted during this update. Within a tile, hardware is advanced in a fixed order, and
+/// messages are delivered in (source tile, post) order, so results do not depend on the number of threads.
+template <typename PIPELINE>
+void SGPDeme::SingleAdvance(const PIPELINE & pipeline) {
+  if (update_mode == UPDATE_MODE__SYNC) {
+    on_deme_single_advance_sig.Trigger();
+    for (Tile & tile : tiles) tile.msg_cnt = 0;
+    workers->Run(tiles.size(), [this, &pipeline](size_t tile_id) {
+      for (size_t id : tiles[tile_id].members) pipeline(grid[id]);
+    });
+    DeliverPosted();
+  } else {
+    const size_t * order = UpdateSchedule();
+    on_deme_single_advance_sig.Trigger();
+    // Distribute CPU cycles.
+    for (size_t i = 0; i < grid.size(); ++i) {
+      pipeline(grid[order[i]]);
+    }
   }
+  on_deme_post_advance_sig.Trigger();
+}
+
+/// Synchronous mode: deliver messages posted during the current update (in parallel over destination tiles).
+void SGPDeme::DeliverPosted() {
+  workers->Run(tiles.size(), [this](size_t tile_id) {
+    for (Tile & src : tiles) {
+      emp::vector<Message> & box = src.outbox[tile_id];
+      for (const Message & msg : box) deliver_fun(msg.dest_id, msg.event);
+      box.clear();
+    }
+  });
 }
 
 void SGPDeme::PrintState(std::ostream & os) {
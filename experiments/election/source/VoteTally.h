@@ -0,0 +1,131 @@
+#ifndef VOTE_TALLY_H
+#define VOTE_TALLY_H
+
+#include <algorithm>
+#include "base/assert.h"
+#include "base/vector.h"
+
+/// Incremental vote tally over a fixed set of candidate UIDs.
+/// - Candidates are mapped to dense indices once (when they're added) using a small open-addressing
+///   table, so checking whether a vote is valid is an array probe rather than a hash set lookup.
+/// - Vote counts live in a flat array stamped with a generation counter; clearing the tally is O(1).
+/// - The running max vote count and leader are maintained on every vote.
+/// NOTE: UID 0 is reserved (it means 'no vote') and can never be a candidate.
+class VoteTally {
+public:
+  static constexpr uint32_t EMPTY_UID = 0;
+  static constexpr size_t NO_INDEX = (size_t)-1;
+
+protected:
+  struct Slot {
+    uint32_t uid;   ///< Candidate UID stored in this slot (EMPTY_UID if slot is open).
+    uint32_t idx;   ///< Dense index of candidate.
+  };
+
+  emp::vector<Slot> table;        ///< Open-addressing table: UID => dense index.
+  size_t table_mask;              ///< table.size() - 1 (table size is always a power of two).
+  size_t table_shift;             ///< Shift used by multiplicative hash.
+  emp::vector<uint32_t> candidates; ///< Dense index => UID.
+
+  emp::vector<uint32_t> counts;   ///< Vote counts by dense index (valid only if stamp matches generation).
+  emp::vector<uint32_t> stamps;   ///< Generation in which each count was last written.
+  uint32_t generation;
+
+  size_t valid_vote_cnt;          ///< Total number of valid votes since last reset.
+  size_t max_vote_cnt;            ///< Highest vote count for any single candidate since last reset.
+  uint32_t leader_uid;            ///< Candidate who (first) reached max_vote_cnt.
+
+  size_t Hash(uint32_t uid) const { return (size_t)((uid * 2654435769u) >> table_shift) & table_mask; }
+
+public:
+  VoteTally()
+    : table(), table_mask(0), table_shift(32), candidates(), counts(), stamps(), generation(1),
+      valid_vote_cnt(0), max_vote_cnt(0), leader_uid(EMPTY_UID)
+  { ; }
+
+  size_t GetCandidateCnt() const { return candidates.size(); }
+  uint32_t GetCandidate(size_t idx) const { return candidates[idx]; }
+  size_t GetValidVoteCnt() const { return valid_vote_cnt; }
+  size_t GetMaxVoteCnt() const { return max_vote_cnt; }
+  uint32_t GetLeaderUID() const { return leader_uid; }
+
+  /// Get vote count (since last reset) for the candidate at dense index idx.
+  size_t GetVoteCnt(size_t idx) const { return (stamps[idx] == generation) ? counts[idx] : 0; }
+
+  /// Get dense index of given UID. Returns NO_INDEX if UID is not a candidate.
+  size_t GetIndex(uint32_t uid) const {
+    if (uid == EMPTY_UID || table.empty()) return NO_INDEX;
+    for (size_t pos = Hash(uid); ; pos = (pos + 1) & table_mask) {
+      const Slot & slot = table[pos];
+      if (slot.uid == uid) return slot.idx;
+      if (slot.uid == EMPTY_UID) return NO_INDEX;
+    }
+  }
+
+  bool IsCandidate(uint32_t uid) const { return GetIndex(uid) != NO_INDEX; }
+
+  void ClearCandidates(size_t expected_cnt);
+  bool AddCandidate(uint32_t uid);
+  void Reset();
+  void Tally(uint32_t vote);
+};
+
+/// Remove all candidates (and reset tally, including leader). Size table for expected_cnt candidates.
+void VoteTally::ClearCandidates(size_t expected_cnt) {
+  size_t table_size = 2;
+  table_shift = 31;
+  while (table_size < 2 * expected_cnt) { table_size <<= 1; --table_shift; }
+  table.resize(table_size);
+  std::fill(table.begin(), table.end(), Slot{EMPTY_UID, 0});
+  table_mask = table_size - 1;
+  candidates.resize(0);
+  counts.resize(0);
+  stamps.resize(0);
+  generation = 1;
+  valid_vote_cnt = 0;
+  max_vote_cnt = 0;
+  leader_uid = EMPTY_UID;
+}
+
+/// Add candidate UID. Returns false (and does nothing) if UID is already a candidate.
+bool VoteTally::AddCandidate(uint32_t uid) {
+  emp_assert(uid != EMPTY_UID, "UID 0 is reserved.");
+  emp_assert(2 * (candidates.size() + 1) <= table.size(), "Vote tally table too small; call ClearCandidates first.");
+  size_t pos = Hash(uid);
+  while (table[pos].uid != EMPTY_UID) {
+    if (table[pos].uid == uid) return false;
+    pos = (pos + 1) & table_mask;
+  }
+  table[pos].uid = uid;
+  table[pos].idx = (uint32_t)candidates.size();
+  candidates.emplace_back(uid);
+  counts.emplace_back(0);
+  stamps.emplace_back(0);
+  return true;
+}
+
+/// Zero out vote counts. Leader UID is left alone (it reflects the most recent tally to produce one).
+void VoteTally::Reset() {
+  valid_vote_cnt = 0;
+  max_vote_cnt = 0;
+  ++generation;
+  if (generation == 0) { // Wrapped around; stamps are no longer trustworthy.
+    std::fill(stamps.begin(), stamps.end(), 0);
+    generation = 1;
+  }
+}
+
+/// Count a vote. Votes for non-candidates are ignored.
+void VoteTally::Tally(uint32_t vote) {
+  const size_t idx = GetIndex(vote);
+  if (idx == NO_INDEX) return;
+  ++valid_vote_cnt;
+  if (stamps[idx] != generation) { stamps[idx] = generation; counts[idx] = 0; }
+  const size_t cnt = ++counts[idx];
+  if (cnt > max_vote_cnt) {
+    max_vote_cnt = cnt;
+    leader_uid = vote;
+  }
+}
+
+#endif
@@ -15,6 +15,16 @@ EMP_BUILD_CONFIG( ConsensusConfig,
   GROUP(DEME_GROUP, "Deme Settings"),
   VALUE(DEME_WIDTH, size_t, 6, "..."),
   VALUE(DEME_HEIGHT, size_t, 6, "..."),
+  VALUE(DEME_UPDATE_MODE, size_t, 0, "How are demes updated? \n0: Asynchronous (one agent at a time, random order)\n1: Synchronous (tiles advanced in parallel; messages delivered between updates)"),
+  VALUE(DEME_TILE_WIDTH, size_t, 16, "Width of deme tiles (only relevant for synchronous deme updates; 0 => deme width)"),
+  VALUE(DEME_TILE_HEIGHT, size_t, 16, "Height of deme tiles (only relevant for synchronous deme updates; 0 => deme height)"),
+  VALUE(DEME_THREADS, size_t, 1, "Number of threads used to advance deme tiles (only relevant for synchronous deme updates; 0 => one per hardware thread)"),
+  VALUE(DEME_SCHEDULE_METHOD, size_t, 0, "How is the order agents are updated in randomized each deme update (asynchronous mode only)? \n0: Full shuffle (used in paper)\n1: Pick from a pool of precomputed permutations\n2: Full shuffle with fast dedicated generator\n3: Random rotation of a per-evaluation order"),
+  VALUE(DEME_SCHEDULE_POOL_SIZE, size_t, 64, "Number of permutations in schedule pool (only relevant for DEME_SCHEDULE_METHOD 1)"),
+  VALUE(DEME_TOPOLOGY, size_t, 0, "Deme neighbor network: \n0: von Neumann torus (4 neighbors)\n1: Moore torus (8 neighbors)\n2: Ring\n3: Random regular graph\n4: Small-world (Watts-Strogatz)\n5: Load edge list from DEME_TOPOLOGY_FPATH"),
+  VALUE(DEME_TOPOLOGY_DEGREE, size_t, 4, "Neighbors per agent in ring, random regular, and small-world topologies (must be even for ring/small-world)"),
+  VALUE(DEME_TOPOLOGY_REWIRE_PROB, double, 0.1, "Per-edge rewiring probability for small-world topology"),
+  VALUE(DEME_TOPOLOGY_FPATH, std::string, "topology.edges", "Edge list file (one 'a b' pair of agent IDs per line) used by edge-list topology"),
   VALUE(INBOX_CAPACITY, size_t, 64, "How big is an agent's message inbox (only relevant for imperative runs)"),
   GROUP(SELECTION_GROUP, "Selection Settings"),
   VALUE(TOURNAMENT_SIZE, size_t, 4, "How big are tournaments when using tournament selection or any selection method that uses tournaments?"),
@@ -33,6 +43,8 @@ EMP_BUILD_CONFIG( ConsensusConfig,
   VALUE(SGP_HW_MAX_CORES, size_t, 16, "Max number of hardware cores; i.e., max number of simultaneous threads of execution hardware will support."),
   VALUE(SGP_HW_MAX_CALL_DEPTH, size_t, 128, "Max call depth of hardware unit"),
   VALUE(SGP_HW_MIN_BIND_THRESH, double, 0.0, "Hardware minimum referencing threshold"),
+  VALUE(SGP_HW_FAST_DISPATCH, bool, false, "Execute instructions through a dense table of plain function pointers (instead of the instruction library's std::function table)?"),
+  VALUE(SGP_HW_FAST_RESET, bool, false, "Restore hardware from a snapshot saved after its first reset (a full copy of the snapshot, instead of resetting it and re-running reset actions every time)?"),
   GROUP(SGP_MUTATION_GROUP, "SignalGP Mutation Settings"),
   VALUE(SGP__PROG_MAX_ARG_VAL, int, 16, "Maximum argument value for instructions."),
   VALUE(SGP__PER_BIT__TAG_BFLIP_RATE, double, 0.005, "Per-bit mutation rate of tag bit flips."),
@@ -46,7 +58,28 @@ EMP_BUILD_CONFIG( ConsensusConfig,
   VALUE(SYSTEMATICS_INTERVAL, size_t, 100, "Interval to record systematics summary stats."),
   VALUE(FITNESS_INTERVAL, size_t, 100, "Interval to record fitness summary stats."),
   VALUE(POP_SNAPSHOT_INTERVAL, size_t, 10000, "Interval to take a full snapshot of the population."),
-  VALUE(DATA_DIRECTORY, std::string, "./", "Location to dump data output.")
+  VALUE(DATA_DIRECTORY, std::string, "./", "Location to dump data output."),
+  VALUE(DATA_FILE_FORMAT, size_t, 0, "Format of fitness, systematics, and dominant data files. 0: CSV; 1: binary columnar (.sgpcol; convert to CSV with colconv)."),
+  VALUE(SYSTEMATICS_MODE, size_t, 0, "How to track phylogenies for the systematics file. 0: world systematics manager; 1: compact (systematics file from genome hashes; the world is built without its systematics manager)."),
+  VALUE(MEMORY_REPORT_INTERVAL, size_t, 0, "Interval to record estimated memory use by subsystem (world, systematics, phenotype cache, hardware) and resident set size to memory.csv (0: off)."),
+  VALUE(TELEMETRY_SHM_NAME, std::string, "", "Name of a shared memory page to publish live stats to each generation (update, generations/sec, instructions/sec, best/mean score, dominant phenotype, ...) for monitors to poll (see the telemetry tool); empty: off."),
+  GROUP(ISLAND_GROUP, "Island Model Settings"),
+  VALUE(ISLAND_CNT, size_t, 1, "Number of island processes, each evolving its own population (1: no island model). Run one process per island, each with its own ISLAND_ID and DATA_DIRECTORY."),
+  VALUE(ISLAND_ID, size_t, 0, "This process's island (0 to ISLAND_CNT-1). Island i uses random seed RANDOM_SEED+i and sends migrants to island i+1."),
+  VALUE(ISLAND_SHM_NAME, std::string, "/sgp_islands", "Name of the shared memory segment islands exchange migrants through (same for all islands of a run; unique among concurrent runs)."),
+  VALUE(ISLAND_MIGRATION_INTERVAL, size_t, 100, "Generations between migrations."),
+  VALUE(ISLAND_MIGRANT_CNT, size_t, 5, "Number of randomly chosen agents sent to the next island each migration (each replaces a random agent there)."),
+  GROUP(ANALYSIS_GROUP, "Analysis Settings"),
+  VALUE(ANALYSIS, size_t, 0, "Which analysis to run. 0: mutational landscape of the agent in ANALYZE_AGENT_FPATH (one row per knockout, function deletion, and random mutant; each evaluated TRIAL_CNT times); 1: treatment sweep of the agent in ANALYZE_AGENT_FPATH (TRIAL_CNT evaluations per treatment; see SWEEP settings); 2: evaluate every agent in the population snapshots in ANALYZE_SNAPSHOT_FPATHS (one row per agent; each evaluated TRIAL_CNT times)."),
+  VALUE(ANALYZE_AGENT_FPATH, std::string, "ancestor.gp", "Path to single agent program to analyze."),
+  VALUE(ANALYZE_SNAPSHOT_FPATHS, std::string, "pop_0.pop", "Comma-separated paths to population snapshot (.pop) files to analyze."),
+  VALUE(ANALYSIS_OUTPUT_FNAME, std::string, "analysis.csv", "Analysis output file."),
+  VALUE(ANALYSIS_THREADS, size_t, 1, "Number of threads used to evaluate analysis programs (every evaluation gets its own random number seed, so results do not depend on thread count; 0 => one per hardware thread)."),
+  VALUE(LANDSCAPE_MUTANT_CNT, size_t, 1000, "Mutational landscape analysis: number of random mutants to evaluate (each mutated once with the SGP mutation rates, as offspring are)."),
+  VALUE(SWEEP_ED_MSG_DELAYS, std::string, "", "Treatment sweep: comma-separated SGP_HW_ED_MSG_DELAY values (empty: configured value)."),
+  VALUE(SWEEP_FORK_ON_MSG, std::string, "", "Treatment sweep: comma-separated SGP_HW_FORK_ON_MSG values (empty: configured value)."),
+  VALUE(SWEEP_DEME_SIZES, std::string, "", "Treatment sweep: comma-separated deme sizes, WIDTHxHEIGHT (e.g., 4x4,6x6,8x8; empty: configured size)."),
+  VALUE(SWEEP_SUMMARY_FNAME, std::string, "sweep_summary.csv", "Treatment sweep: per-treatment consensus time (over evaluations that reached consensus) and message count distributions.")
 )
 
 #endif